@@ -0,0 +1,76 @@
+#include <string>
+#include <vector>
+#include "benchmark_tools.hpp"
+#include "qtfy/random.hpp"
+#include "qtfy/random/any_counter_engine.hpp"
+
+using namespace qtfy::random;
+using namespace qtfy::benchmark;
+
+// the engine used directly against the same engine behind the virtual
+// dispatch of any_counter_engine, with 4 KiB batches.
+template <class trait_t>
+void benchmark_spec(const std::string& spec)
+{
+  constexpr std::size_t iterations = 200'000;
+  constexpr uint64_t seed = 1U;
+  std::cout << spec << '\n';
+
+  counter_based_engine<trait_t, uint64_t> e1{
+      fold_in<trait_t>(typename trait_t::key_type{}, seed)};
+  std::vector<uint64_t> values(4096U / sizeof(uint64_t));
+  const double direct = run(
+      "  generate", iterations,
+      [&] {
+        e1.generate(values);
+        do_not_optimize(values.front());
+      },
+      values.size());
+
+  auto e2 = *make_any_counter_engine(spec, seed);
+  run("  any_counter_engine::fill", iterations,
+      [&] {
+        e2.fill(values);
+        do_not_optimize(values.front());
+      },
+      values.size());
+
+  auto e3 = e1;
+  std::vector<double> canonical(4096U / sizeof(double));
+  const double direct_canonical = run(
+      "  fill_canonical", iterations,
+      [&] {
+        e3.fill_canonical(std::span<double>{canonical});
+        do_not_optimize(canonical.front());
+      },
+      canonical.size());
+
+  auto e4 = *make_any_counter_engine(spec, seed);
+  run("  any_counter_engine::fill_canonical", iterations,
+      [&] {
+        e4.fill_canonical(canonical);
+        do_not_optimize(canonical.front());
+      },
+      canonical.size());
+
+  // the two runs above differ by less than the noise of the machine, so the
+  // cost of the dispatch itself is measured with empty batches.
+  auto e5 = *make_any_counter_engine(spec, seed);
+  const double dispatch =
+      run("  any_counter_engine::fill, empty batch", iterations * 100U,
+          [&] { e5.fill(std::span<uint64_t>{values.data(), 0U}); });
+
+  const auto batch = static_cast<double>(values.size());
+  std::cout << "  dispatch per 4 KiB batch "
+            << 100.0 * dispatch / (direct * batch) << " %, "
+            << 100.0 * dispatch / (direct_canonical * batch)
+            << " % canonical\n";
+}
+
+int main()
+{
+  benchmark_spec<philox4x32_trait<10>>("philox4x32-10");
+  benchmark_spec<philox4x64_trait<10>>("philox4x64-10");
+  benchmark_spec<threefry4x64_trait<20>>("threefry4x64-20");
+  benchmark_spec<threefry2x32_trait<20>>("threefry2x32-20");
+}
@@ -0,0 +1,48 @@
+#ifndef QUANTIFEYE_BENCHMARK_TOOLS_HPP
+#define QUANTIFEYE_BENCHMARK_TOOLS_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string_view>
+
+namespace qtfy::benchmark {
+
+// prevents the compiler from optimising away the computation of value.
+template <class T>
+void do_not_optimize(const T& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// runs f iterations times after a short warm up and prints the average time
+// per item, where a single call to f processes items_per_iteration items.
+template <class F>
+double run(std::string_view name, std::size_t iterations, F&& f,
+           std::size_t items_per_iteration = 1U)
+{
+  for (std::size_t i{}; i < iterations / 10U + 1U; ++i)
+  {
+    f();
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i{}; i < iterations; ++i)
+  {
+    f();
+  }
+  const auto stop = std::chrono::steady_clock::now();
+
+  const std::chrono::duration<double, std::nano> elapsed = stop - start;
+  const double result =
+      elapsed.count() / static_cast<double>(iterations * items_per_iteration);
+  std::cout << std::left << std::setw(48) << name << std::right
+            << std::setw(12) << std::fixed << std::setprecision(3) << result
+            << " ns/item\n";
+  return result;
+}
+
+}  // namespace qtfy::benchmark
+
+#endif  // QUANTIFEYE_BENCHMARK_TOOLS_HPP
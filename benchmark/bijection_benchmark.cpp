@@ -0,0 +1,149 @@
+#include <algorithm>
+#include <vector>
+#include "benchmark_tools.hpp"
+#include "qtfy/random.hpp"
+
+using namespace qtfy::random;
+using namespace qtfy::benchmark;
+
+template <class trait_t, class kernel_t>
+void benchmark_trait(std::string_view name)
+{
+  using counter_t = typename trait_t::counter_type;
+  constexpr std::size_t batch = 1024;
+  constexpr std::size_t iterations = 2000;
+  std::cout << name << '\n';
+
+  std::vector<counter_t> input(batch);
+  std::vector<counter_t> output(batch);
+  counter_t ctr{};
+  for (auto& x : input)
+  {
+    x = ++ctr;
+  }
+  const auto key = trait_t::set_key({});
+
+  run(
+      "  scalar bijection", iterations,
+      [&] {
+        for (std::size_t i{}; i < batch; ++i)
+        {
+          output[i] = trait_t::bijection(input[i], key);
+        }
+        do_not_optimize(output.front());
+      },
+      batch);
+
+  // the key is expanded for every call, as for a short lived bijection.
+  run(
+      "  scalar bijection, set_key per call", iterations,
+      [&] {
+        for (std::size_t i{}; i < batch; ++i)
+        {
+          const typename trait_t::key_type raw_key{
+              static_cast<typename trait_t::word_type>(i)};
+          output[i] = trait_t::bijection(input[i], trait_t::set_key(raw_key));
+        }
+        do_not_optimize(output.front());
+      },
+      batch);
+
+  run(
+      "  interleaved bijection_n", iterations,
+      [&] {
+        constexpr std::size_t n = trait_t::interleave;
+        std::array<counter_t, n> group{};
+        for (std::size_t i{}; i < batch; i += n)
+        {
+          std::copy_n(input.begin() + static_cast<std::ptrdiff_t>(i), n,
+                      group.begin());
+          group = trait_t::bijection_n(group, key);
+          std::copy(group.begin(), group.end(),
+                    output.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        do_not_optimize(output.front());
+      },
+      batch);
+
+  run(
+      "  bijection_batch", iterations,
+      [&] {
+        trait_t::bijection_batch(input, output, key);
+        do_not_optimize(output.front());
+      },
+      batch);
+
+  // one counter for many keys, e.g. a time step shared by all agents.
+  std::vector<typename trait_t::key_type> keys(batch);
+  for (std::size_t i{}; i < batch; ++i)
+  {
+    keys[i] = typename trait_t::key_type{
+        static_cast<typename trait_t::word_type>(i)};
+  }
+  run(
+      "  bijection_keys", iterations,
+      [&] {
+        trait_t::bijection_keys(ctr, keys, output);
+        do_not_optimize(output.front());
+      },
+      batch);
+
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+  run(
+      "  portable kernel", iterations,
+      [&] {
+        kernel_t::portable(input.data(), output.data(), batch, key);
+        do_not_optimize(output.front());
+      },
+      batch);
+#endif
+
+#if QTFY_RANDOM_X86_SIMD
+  if (__builtin_cpu_supports("avx2"))
+  {
+    run(
+        "  avx2 kernel", iterations,
+        [&] {
+          kernel_t::avx2(input.data(), output.data(), batch, key);
+          do_not_optimize(output.front());
+        },
+        batch);
+  }
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    run(
+        "  avx512 kernel", iterations,
+        [&] {
+          kernel_t::avx512(input.data(), output.data(), batch, key);
+          do_not_optimize(output.front());
+        },
+        batch);
+  }
+#endif
+}
+
+template <class trait_t>
+void benchmark_philox(std::string_view name)
+{
+  benchmark_trait<trait_t, simd::philox_kernel<trait_t>>(name);
+}
+
+template <class trait_t>
+void benchmark_threefry(std::string_view name)
+{
+  benchmark_trait<trait_t, simd::threefry_kernel<trait_t>>(name);
+}
+
+int main()
+{
+  std::cout << "active instruction set: "
+            << simd::to_string(simd::active_instruction_set()) << '\n';
+  benchmark_philox<philox4x32_trait<10>>("philox4x32-10");
+  benchmark_philox<philox2x32_trait<10>>("philox2x32-10");
+  benchmark_philox<philox4x64_trait<10>>("philox4x64-10");
+  benchmark_philox<philox2x64_trait<10>>("philox2x64-10");
+  benchmark_threefry<threefry4x64_trait<20>>("threefry4x64-20");
+  benchmark_threefry<threefry2x64_trait<20>>("threefry2x64-20");
+  benchmark_threefry<threefry4x32_trait<20>>("threefry4x32-20");
+  benchmark_threefry<threefry2x32_trait<20>>("threefry2x32-20");
+}
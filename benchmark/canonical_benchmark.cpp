@@ -0,0 +1,54 @@
+#include <cmath>
+#include <vector>
+#include "benchmark_tools.hpp"
+#include "qtfy/random.hpp"
+
+using namespace qtfy::random;
+using namespace qtfy::benchmark;
+
+// the conversion that next_canonical used before it multiplied by a constant.
+template <class engine_t>
+double scalbn_canonical(engine_t& engine)
+{
+  return std::scalbn(static_cast<double>(engine() >> 11U), -53);
+}
+
+template <class engine_t>
+void benchmark_engine(std::string_view name)
+{
+  constexpr std::size_t iterations = 10'000'000;
+  std::cout << name << '\n';
+
+  engine_t e1{};
+  run("  scalbn (previous implementation)", iterations,
+      [&] { do_not_optimize(scalbn_canonical(e1)); });
+
+  engine_t e2{};
+  run("  next_canonical [0, 1)", iterations,
+      [&] { do_not_optimize(e2.next_canonical()); });
+
+  engine_t e3{};
+  run("  next_canonical (0, 1)", iterations, [&] {
+    do_not_optimize(
+        e3.template next_canonical<double, 53, canonical_interval::open_open>());
+  });
+
+  engine_t e4{};
+  std::vector<double> values(4096);
+  run(
+      "  fill_canonical [0, 1)", iterations / values.size(),
+      [&] {
+        e4.fill_canonical(std::span<double>{values});
+        do_not_optimize(values.front());
+      },
+      values.size());
+}
+
+int main()
+{
+  benchmark_engine<threefry4x64<>>("threefry4x64");
+  benchmark_engine<philox4x64<>>("philox4x64");
+  benchmark_engine<philox2x64<>>("philox2x64");
+  benchmark_engine<philox4x64<uint64_t, 10, 16>>("philox4x64, depth 16");
+  benchmark_engine<threefry4x64<uint64_t, 20, 16>>("threefry4x64, depth 16");
+}
@@ -0,0 +1,128 @@
+#include <vector>
+#include "benchmark_tools.hpp"
+#include "qtfy/random.hpp"
+
+using namespace qtfy::random;
+using namespace qtfy::benchmark;
+
+// the word by word addition that operator+= used before it propagated the
+// carry without branching on it.
+template <class word_t, std::size_t words>
+void loop_add(counter<word_t, words>& ctr, uint64_t addend)
+{
+  for (std::size_t i{}; addend && i != words; ++i)
+  {
+    const word_t old_value = ctr[i];
+    const word_t new_value = old_value + static_cast<word_t>(addend);
+    ctr[i] = new_value;
+    if constexpr (sizeof(word_t) < sizeof(uint64_t))
+    {
+      addend >>= std::numeric_limits<word_t>::digits;
+    }
+    else
+    {
+      addend = 0U;
+    }
+    if (new_value < old_value)
+    {
+      ++addend;
+    }
+  }
+}
+
+template <class word_t, std::size_t words>
+void benchmark_counter(std::string_view name)
+{
+  using counter_t = counter<word_t, words>;
+  constexpr std::size_t batch = 1024;
+  constexpr std::size_t iterations = 20000;
+  std::cout << name << '\n';
+
+  // counters close to a word boundary, so that some additions carry.
+  std::vector<counter_t> counters(batch);
+  std::vector<uint64_t> small(batch);
+  std::vector<uint64_t> large(batch);
+  uint64_t state = 0x9E3779B97F4A7C15U;
+  for (std::size_t i{}; i < batch; ++i)
+  {
+    state = state * 6364136223846793005U + 1442695040888963407U;
+    counters[i].fill(static_cast<word_t>(state));
+    small[i] = state >> 60U;
+    large[i] = state;
+  }
+
+  run(
+      "  operator++", iterations,
+      [&] {
+        for (auto& ctr : counters)
+        {
+          ++ctr;
+        }
+        do_not_optimize(counters.front());
+      },
+      batch);
+
+  run(
+      "  operator+= small addend", iterations,
+      [&] {
+        for (std::size_t i{}; i < batch; ++i)
+        {
+          counters[i] += static_cast<word_t>(small[i]);
+        }
+        do_not_optimize(counters.front());
+      },
+      batch);
+
+  run(
+      "  operator+= large addend", iterations,
+      [&] {
+        for (std::size_t i{}; i < batch; ++i)
+        {
+          counters[i] += large[i];
+        }
+        do_not_optimize(counters.front());
+      },
+      batch);
+
+  run(
+      "  word loop, large addend (previous)", iterations,
+      [&] {
+        for (std::size_t i{}; i < batch; ++i)
+        {
+          loop_add(counters[i], large[i]);
+        }
+        do_not_optimize(counters.front());
+      },
+      batch);
+
+  run(
+      "  operator-= large addend", iterations,
+      [&] {
+        for (std::size_t i{}; i < batch; ++i)
+        {
+          counters[i] -= large[i];
+        }
+        do_not_optimize(counters.front());
+      },
+      batch);
+
+  std::vector<counter<uint8_t, sizeof(counter_t)>> bytes(batch);
+  run(
+      "  reinterpret<uint8_t>", iterations,
+      [&] {
+        for (std::size_t i{}; i < batch; ++i)
+        {
+          bytes[i] = reinterpret<uint8_t>(counters[i]);
+        }
+        do_not_optimize(bytes.front());
+      },
+      batch);
+}
+
+int main()
+{
+  benchmark_counter<uint32_t, 2>("counter<uint32_t, 2>");
+  benchmark_counter<uint32_t, 4>("counter<uint32_t, 4>");
+  benchmark_counter<uint64_t, 2>("counter<uint64_t, 2>");
+  benchmark_counter<uint64_t, 4>("counter<uint64_t, 4>");
+}
@@ -0,0 +1,58 @@
+#include <vector>
+#include "benchmark_tools.hpp"
+#include "qtfy/random.hpp"
+
+using namespace qtfy::random;
+using namespace qtfy::benchmark;
+
+template <class engine_t>
+void benchmark_engine(std::string_view name, engine_t engine)
+{
+  constexpr std::size_t iterations = 10'000'000;
+  std::cout << name << '\n';
+
+  auto e1 = engine;
+  run("  operator()", iterations, [&] { do_not_optimize(e1()); });
+
+  auto e2 = engine;
+  run("  next_canonical", iterations,
+      [&] { do_not_optimize(e2.next_canonical()); });
+
+  auto e3 = engine;
+  std::vector<typename engine_t::result_type> values(4096);
+  run(
+      "  generate", iterations / values.size(),
+      [&] {
+        e3.generate(values);
+        do_not_optimize(values.front());
+      },
+      values.size());
+}
+
+// the same stream with the key given at runtime and at compile time.
+template <class trait_t, typename trait_t::key_type key, size_t depth = 1U>
+void benchmark_trait(std::string_view name)
+{
+  using result_t = typename trait_t::word_type;
+  std::cout << name << '\n';
+  benchmark_engine(" runtime key",
+                   counter_based_engine<trait_t, result_t, depth>{key});
+  benchmark_engine(" compile time key",
+                   static_key_counter_engine<trait_t, key, result_t, depth>{});
+}
+
+int main()
+{
+  using threefry_t = threefry4x64_trait<20>;
+  using philox_t = philox4x64_trait<10>;
+  benchmark_trait<threefry_t, threefry_t::key_type{1U, 2U, 3U, 4U}>(
+      "threefry4x64");
+  benchmark_trait<philox_t, philox_t::key_type{1U, 2U}>("philox4x64");
+  benchmark_trait<threefry4x32_trait<20>,
+                  threefry4x32_trait<20>::key_type{1U, 2U, 3U, 4U}>(
+      "threefry4x32");
+  benchmark_trait<philox4x32_trait<10>, philox4x32_trait<10>::key_type{1U, 2U}>(
+      "philox4x32");
+  benchmark_trait<threefry_t, threefry_t::key_type{1U, 2U, 3U, 4U}, 16U>(
+      "threefry4x64, depth 16");
+}
@@ -1,6 +1,7 @@
 #include <algorithm>
 #include <execution>
 #include <memory>
+#include <numeric>
 #include <random>
 #include <ranges>
 #include <vector>
@@ -80,6 +81,28 @@ int main()
 
   new_line();
 
+  print_line("access the same stream at random, without generating it:");
+  using trait_t = qtfy::random::threefry4x64_trait<20>;
+  const qtfy::random::counter_stream_view<trait_t> stream{{1, 0, 0, 0}};
+  print_line(stream.begin()[9]);
+  print_line(stream.begin()[1'000'000'000]);
+
+  new_line();
+
+  print_line("average canonical values, with the stream split in chunks:");
+  const auto canonical = stream.canonical<double>();
+  constexpr std::ptrdiff_t chunk = 25000;
+  double sum{};
+  for (auto first = canonical.begin(); first != canonical.begin() + 4 * chunk;
+       first += chunk)
+  {
+    // each chunk could run on a different thread.
+    sum += std::reduce(first, first + chunk);
+  }
+  print_line(sum / (4 * chunk));
+
+  new_line();
+
   print_line("print some normally distributed values:");
   auto normal_values = standard_normal_stream(1);
   for (auto x : normal_values | take(10))
@@ -93,5 +116,5 @@ int main()
   auto amount = 100000;
   auto c =
       count_if(normal_values | take(amount), [](auto x) { return x < 0.675; });
-  print_line(c / static_cast<double>(amount));
+  print_line(static_cast<double>(c) / static_cast<double>(amount));
 }
@@ -1,38 +1,62 @@
 #ifndef QTFY_RANDOM_HPP
 #define QTFY_RANDOM_HPP
 
+#include "qtfy/random/compact_counter_engine.hpp"
 #include "qtfy/random/counter.hpp"
 #include "qtfy/random/counter_based_engine.hpp"
+#include "qtfy/random/counter_stream_view.hpp"
+#include "qtfy/random/engine_bank.hpp"
+#include "qtfy/random/key_derivation.hpp"
 #include "qtfy/random/philox_trait.hpp"
+#include "qtfy/random/shared_counter_engine.hpp"
+#include "qtfy/random/static_key_counter_engine.hpp"
 #include "qtfy/random/threefry_trait.hpp"
 #include "qtfy/random/utlities.hpp"
 #include "qtfy/random/counter_based_engine_with_bijection.hpp"
 
 namespace qtfy::random {
 
-template <class return_t = uint64_t, unsigned rounds = 20>
-using threefry2x64 = counter_based_engine<threefry2x64_trait<rounds>, return_t>;
+template <class return_t = uint64_t, unsigned rounds = 20, size_t depth = 1U>
+using threefry2x64 =
+    counter_based_engine<threefry2x64_trait<rounds>, return_t, depth>;
 
-template <class return_t = uint32_t, unsigned rounds = 20>
-using threefry2x32 = counter_based_engine<threefry2x32_trait<rounds>, return_t>;
+template <class return_t = uint32_t, unsigned rounds = 20, size_t depth = 1U>
+using threefry2x32 =
+    counter_based_engine<threefry2x32_trait<rounds>, return_t, depth>;
 
-template <class return_t = uint64_t, unsigned rounds = 20>
-using threefry4x64 = counter_based_engine<threefry4x64_trait<rounds>, return_t>;
+template <class return_t = uint64_t, unsigned rounds = 20, size_t depth = 1U>
+using threefry4x64 =
+    counter_based_engine<threefry4x64_trait<rounds>, return_t, depth>;
 
-template <class return_t = uint32_t, unsigned rounds = 20>
-using threefry4x32 = counter_based_engine<threefry4x32_trait<rounds>, return_t>;
+template <class return_t = uint32_t, unsigned rounds = 20, size_t depth = 1U>
+using threefry4x32 =
+    counter_based_engine<threefry4x32_trait<rounds>, return_t, depth>;
 
-template <class return_t = uint64_t, unsigned rounds = 10>
-using philox2x64 = counter_based_engine<philox2x64_trait<rounds>, return_t>;
+template <class return_t = uint64_t, unsigned rounds = 20, size_t depth = 1U>
+using threefry4x64_runtime_tweak =
+    counter_based_engine<threefry4x64_runtime_tweak_trait<rounds>, return_t,
+                         depth>;
 
-template <class return_t = uint32_t, unsigned rounds = 10>
-using philox2x32 = counter_based_engine<philox2x32_trait<rounds>, return_t>;
+template <class return_t = uint32_t, unsigned rounds = 20, size_t depth = 1U>
+using threefry4x32_runtime_tweak =
+    counter_based_engine<threefry4x32_runtime_tweak_trait<rounds>, return_t,
+                         depth>;
 
-template <class return_t = uint64_t, unsigned rounds = 10>
-using philox4x64 = counter_based_engine<philox4x64_trait<rounds>, return_t>;
+template <class return_t = uint64_t, unsigned rounds = 10, size_t depth = 1U>
+using philox2x64 =
+    counter_based_engine<philox2x64_trait<rounds>, return_t, depth>;
 
-template <class return_t = uint32_t, unsigned rounds = 10>
-using philox4x32 = counter_based_engine<philox4x32_trait<rounds>, return_t>;
+template <class return_t = uint32_t, unsigned rounds = 10, size_t depth = 1U>
+using philox2x32 =
+    counter_based_engine<philox2x32_trait<rounds>, return_t, depth>;
+
+template <class return_t = uint64_t, unsigned rounds = 10, size_t depth = 1U>
+using philox4x64 =
+    counter_based_engine<philox4x64_trait<rounds>, return_t, depth>;
+
+template <class return_t = uint32_t, unsigned rounds = 10, size_t depth = 1U>
+using philox4x32 =
+    counter_based_engine<philox4x32_trait<rounds>, return_t, depth>;
 
 
 }  // namespace qtfy::random
@@ -0,0 +1,365 @@
+#ifndef QTFY_RANDOM_ANY_COUNTER_ENGINE_HPP
+#define QTFY_RANDOM_ANY_COUNTER_ENGINE_HPP
+
+#include <concepts>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "counter_based_engine.hpp"
+#include "key_derivation.hpp"
+#include "philox_trait.hpp"
+#include "threefry_trait.hpp"
+
+namespace qtfy::random {
+
+enum class bijection_family
+{
+  philox,
+  threefry
+};
+
+constexpr std::string_view to_string(bijection_family family) noexcept
+{
+  switch (family)
+  {
+    case bijection_family::philox:
+      return "philox";
+    case bijection_family::threefry:
+      return "threefry";
+  }
+  return "unknown";
+}
+
+/**
+ * The bijection of a counter based engine chosen at runtime, e.g. from a
+ * configuration file. The defaults are those of philox4x32<>.
+ */
+struct engine_spec
+{
+  bijection_family family{bijection_family::philox};
+  unsigned words{4U};
+  unsigned word_bits{32U};
+  unsigned rounds{10U};
+
+  friend constexpr bool operator==(const engine_spec&,
+                                   const engine_spec&) noexcept = default;
+};
+
+namespace detail {
+
+// consumes the leading decimal digits of text, if there are any.
+constexpr std::optional<unsigned> consume_unsigned(
+    std::string_view& text) noexcept
+{
+  size_t length{};
+  unsigned value{};
+  for (; length < text.size() && text[length] >= '0' && text[length] <= '9';
+       ++length)
+  {
+    if (value > 100'000U)
+    {
+      return std::nullopt;
+    }
+    value = value * 10U + static_cast<unsigned>(text[length] - '0');
+  }
+  if (length == 0U)
+  {
+    return std::nullopt;
+  }
+  text.remove_prefix(length);
+  return value;
+}
+
+}  // namespace detail
+
+/**
+ * Parses a spec in the notation of the engine aliases, i.e.
+ * <family><words>x<word_bits>[-<rounds>] such as "philox4x32-10" or
+ * "threefry2x64". Without rounds, the default of the alias in random.hpp is
+ * used, 10 for philox and 20 for threefry. Returns std::nullopt if text is
+ * malformed or names a shape no trait has. Rounds are not checked here,
+ * make_any_counter_engine rejects the ones it is not built for.
+ */
+constexpr std::optional<engine_spec> parse_engine_spec(
+    std::string_view text) noexcept
+{
+  engine_spec spec{};
+  if (text.starts_with(to_string(bijection_family::philox)))
+  {
+    spec.family = bijection_family::philox;
+    spec.rounds = 10U;
+  }
+  else if (text.starts_with(to_string(bijection_family::threefry)))
+  {
+    spec.family = bijection_family::threefry;
+    spec.rounds = 20U;
+  }
+  else
+  {
+    return std::nullopt;
+  }
+  text.remove_prefix(to_string(spec.family).size());
+
+  const auto words = detail::consume_unsigned(text);
+  if (!words || !text.starts_with('x'))
+  {
+    return std::nullopt;
+  }
+  text.remove_prefix(1U);
+  const auto word_bits = detail::consume_unsigned(text);
+  if (!word_bits)
+  {
+    return std::nullopt;
+  }
+  if (text.starts_with('-'))
+  {
+    text.remove_prefix(1U);
+    const auto rounds = detail::consume_unsigned(text);
+    if (!rounds)
+    {
+      return std::nullopt;
+    }
+    spec.rounds = *rounds;
+  }
+  if (!text.empty() || (*words != 2U && *words != 4U) ||
+      (*word_bits != 32U && *word_bits != 64U))
+  {
+    return std::nullopt;
+  }
+  spec.words = *words;
+  spec.word_bits = *word_bits;
+  return spec;
+}
+
+// the notation parse_engine_spec reads, with the rounds always spelled out.
+inline std::string to_string(const engine_spec& spec)
+{
+  return std::string{to_string(spec.family)} + std::to_string(spec.words) +
+         'x' + std::to_string(spec.word_bits) + '-' +
+         std::to_string(spec.rounds);
+}
+
+/**
+ * A counter based engine of 64 bit values whose type is erased, so that the
+ * bijection can be chosen at runtime. Values are only drawn in batches:
+ * fill and fill_canonical make one virtual call, which then runs the
+ * generate or fill_canonical of the engine behind it, so the dispatch is
+ * paid once per batch and not once per value. There is deliberately no
+ * operator(), callers that draw value by value keep a buffer and refill it.
+ *
+ * fill and fill_canonical continue the same sequence of values as the
+ * engine behind them, as the generate and fill_canonical of that engine do.
+ *
+ * @note
+ * A moved-from any_counter_engine can only be copied, assigned to or
+ * destroyed, and its copies are moved-from as well.
+ */
+class any_counter_engine
+{
+  struct engine_interface
+  {
+    virtual ~engine_interface() = default;
+    virtual std::unique_ptr<engine_interface> clone() const = 0;
+    virtual void fill(std::span<uint64_t> values) noexcept = 0;
+    virtual void fill_canonical(std::span<double> values) noexcept = 0;
+    virtual void discard(unsigned long long steps) noexcept = 0;
+  };
+
+  template <class engine_t>
+  struct engine_model final : engine_interface
+  {
+    engine_t engine;
+
+    explicit engine_model(const engine_t& e) : engine{e} {}
+
+    std::unique_ptr<engine_interface> clone() const override
+    {
+      return std::make_unique<engine_model>(engine);
+    }
+
+    void fill(std::span<uint64_t> values) noexcept override
+    {
+      engine.generate(values);
+    }
+
+    void fill_canonical(std::span<double> values) noexcept override
+    {
+      engine.fill_canonical(values);
+    }
+
+    void discard(unsigned long long steps) noexcept override
+    {
+      engine.discard(steps);
+    }
+  };
+
+  std::unique_ptr<engine_interface> m_engine;
+
+ public:
+  using result_type = uint64_t;
+
+  /**
+   * Erases the type of engine, which continues its sequence from its
+   * current state.
+   */
+  template <class engine_t>
+  requires std::same_as<typename engine_t::result_type, uint64_t> &&
+      requires(engine_t& e, std::span<uint64_t> values,
+               std::span<double> canonical, unsigned long long steps)
+  {
+    e.generate(values);
+    e.fill_canonical(canonical);
+    e.discard(steps);
+  }
+  explicit any_counter_engine(const engine_t& engine)
+      : m_engine{std::make_unique<engine_model<engine_t>>(engine)}
+  {
+  }
+
+  any_counter_engine(const any_counter_engine& other)
+      : m_engine{other.m_engine ? other.m_engine->clone() : nullptr}
+  {
+  }
+
+  any_counter_engine(any_counter_engine&&) noexcept = default;
+
+  any_counter_engine& operator=(const any_counter_engine& other)
+  {
+    if (this != &other)
+    {
+      m_engine = other.m_engine ? other.m_engine->clone() : nullptr;
+    }
+    return *this;
+  }
+
+  any_counter_engine& operator=(any_counter_engine&&) noexcept = default;
+
+  ~any_counter_engine() = default;
+
+  // fills values with the next values.size() outputs of the engine.
+  void fill(std::span<uint64_t> values) noexcept { m_engine->fill(values); }
+
+  /**
+   * Fills values with canonical doubles in [0, 1) of 53 bits each, the
+   * sequence that next_canonical() of the engine behind it would produce.
+   */
+  void fill_canonical(std::span<double> values) noexcept
+  {
+    m_engine->fill_canonical(values);
+  }
+
+  void discard(unsigned long long steps) noexcept { m_engine->discard(steps); }
+
+  static constexpr uint64_t max() noexcept
+  {
+    return std::numeric_limits<uint64_t>::max();
+  }
+
+  static constexpr uint64_t min() noexcept
+  {
+    return std::numeric_limits<uint64_t>::min();
+  }
+};
+
+namespace detail {
+
+// the engine of the first of rounds that equals spec_rounds, if there is one.
+template <template <unsigned> class trait_t, unsigned... rounds>
+std::optional<any_counter_engine> make_any_counter_engine(
+    std::integer_sequence<unsigned, rounds...>, unsigned spec_rounds,
+    uint64_t seed)
+{
+  std::optional<any_counter_engine> engine{};
+  auto make = [&]<unsigned r>() {
+    using trait_type = trait_t<r>;
+    engine.emplace(counter_based_engine<trait_type, uint64_t>{
+        fold_in<trait_type>(typename trait_type::key_type{}, seed)});
+  };
+  ((spec_rounds == rounds && (make.template operator()<rounds>(), true)) ||
+   ...);
+  return engine;
+}
+
+}  // namespace detail
+
+/**
+ * Builds the engine of spec, counter_based_engine<trait_t, uint64_t> keyed
+ * with fold_in<trait_t>({}, seed), so that every shape derives its key from
+ * the same 64 bit seed. The rounds an engine can be built with are fixed at
+ * compile time by philox_rounds and threefry_rounds, by default 7 and 10
+ * for philox and 12, 13 and 20 for threefry, which are the counts of
+ * Random123. Returns std::nullopt for any other spec.
+ *
+ * @note
+ * The engines are only instantiated in the translation units that call the
+ * factory, once for every shape and count of rounds.
+ */
+template <class philox_rounds = std::integer_sequence<unsigned, 7U, 10U>,
+          class threefry_rounds =
+              std::integer_sequence<unsigned, 12U, 13U, 20U>>
+std::optional<any_counter_engine> make_any_counter_engine(
+    const engine_spec& spec, uint64_t seed)
+{
+  const unsigned shape = spec.words * 100U + spec.word_bits;
+  if (spec.family == bijection_family::philox)
+  {
+    switch (shape)
+    {
+      case 232U:
+        return detail::make_any_counter_engine<philox2x32_trait>(
+            philox_rounds{}, spec.rounds, seed);
+      case 264U:
+        return detail::make_any_counter_engine<philox2x64_trait>(
+            philox_rounds{}, spec.rounds, seed);
+      case 432U:
+        return detail::make_any_counter_engine<philox4x32_trait>(
+            philox_rounds{}, spec.rounds, seed);
+      case 464U:
+        return detail::make_any_counter_engine<philox4x64_trait>(
+            philox_rounds{}, spec.rounds, seed);
+      default:
+        return std::nullopt;
+    }
+  }
+  switch (shape)
+  {
+    case 232U:
+      return detail::make_any_counter_engine<threefry2x32_trait>(
+          threefry_rounds{}, spec.rounds, seed);
+    case 264U:
+      return detail::make_any_counter_engine<threefry2x64_trait>(
+          threefry_rounds{}, spec.rounds, seed);
+    case 432U:
+      return detail::make_any_counter_engine<threefry4x32_trait>(
+          threefry_rounds{}, spec.rounds, seed);
+    case 464U:
+      return detail::make_any_counter_engine<threefry4x64_trait>(
+          threefry_rounds{}, spec.rounds, seed);
+    default:
+      return std::nullopt;
+  }
+}
+
+// parses spec with parse_engine_spec and builds its engine.
+template <class philox_rounds = std::integer_sequence<unsigned, 7U, 10U>,
+          class threefry_rounds =
+              std::integer_sequence<unsigned, 12U, 13U, 20U>>
+std::optional<any_counter_engine> make_any_counter_engine(
+    std::string_view spec, uint64_t seed)
+{
+  const auto parsed = parse_engine_spec(spec);
+  if (!parsed)
+  {
+    return std::nullopt;
+  }
+  return make_any_counter_engine<philox_rounds, threefry_rounds>(*parsed,
+                                                                 seed);
+}
+
+}  // namespace qtfy::random
+
+#endif
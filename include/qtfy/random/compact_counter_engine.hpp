@@ -0,0 +1,157 @@
+#ifndef QTFY_RANDOM_COMPACT_COUNTER_ENGINE_HPP
+#define QTFY_RANDOM_COMPACT_COUNTER_ENGINE_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <span>
+#include "counter_based_engine.hpp"
+
+namespace qtfy::random {
+
+/**
+ * A uniform random bit generator that draws the same sequence as
+ * counter_based_engine<trait_t, result_t> but holds no buffer: its state is
+ * the key, the counter of the current block and the index of the next value
+ * within that block. Blocks are computed when a value is drawn, so
+ * construction and discard never call the bijection, and the engine is
+ * trivially copyable, which suits containers of one generator per entity.
+ *
+ * @note
+ * Each draw computes the block of the value it returns, including the
+ * internal key, so drawing value by value costs a bijection per value. In
+ * exchange the state holds the key and not the internal key, which for
+ * philox is the schedule of all round keys.
+ * generate computes every block it needs once, with the batch bijection.
+ */
+template <class trait_t,
+          std::unsigned_integral result_t = typename trait_t::word_type>
+class compact_counter_engine
+{
+ public:
+  using trait_type = trait_t;
+  using result_type = result_t;
+  using key_type = typename trait_t::key_type;
+  using counter_type = typename trait_t::counter_type;
+  using internal_key_type = typename trait_t::internal_key_type;
+  using engine_type = counter_based_engine<trait_t, result_t>;
+  using block_type = typename engine_type::block_type;
+
+  static constexpr size_t block_size = block_type{}.size();
+
+ private:
+  static constexpr size_t batch_size = 16U;
+
+  counter_type m_counter{};
+  key_type m_key{};
+  // the index of the next value within the block of m_counter.
+  uint32_t m_index{};
+
+  constexpr block_type block(counter_type ctr) const noexcept
+  {
+    return engine_type::bijection(ctr, trait_t::set_key(m_key));
+  }
+
+ public:
+  constexpr compact_counter_engine() noexcept = default;
+
+  constexpr compact_counter_engine(key_type key, counter_type counter) noexcept
+      : m_counter{counter}, m_key{key}
+  {
+  }
+
+  explicit constexpr compact_counter_engine(key_type key) noexcept
+      : m_key{key}
+  {
+  }
+
+  constexpr result_t operator()() noexcept
+  {
+    const result_t value = block(m_counter)[m_index];
+    if (++m_index == block_size)
+    {
+      m_index = 0U;
+      ++m_counter;
+    }
+    return value;
+  }
+
+  /**
+   * Advances the engine by steps values. Only the counter and the index
+   * change, no block is computed.
+   */
+  constexpr void discard(unsigned long long steps) noexcept
+  {
+    const unsigned long long offset = m_index + steps % block_size;
+    m_counter += steps / block_size + offset / block_size;
+    m_index = static_cast<uint32_t>(offset % block_size);
+  }
+
+  /**
+   * Returns the value that operator() would return after n further calls
+   * without changing the state of the engine.
+   */
+  constexpr result_t at(unsigned long long n) const noexcept
+  {
+    const unsigned long long offset = m_index + n % block_size;
+    return block(m_counter + (n / block_size + offset / block_size))
+        [offset % block_size];
+  }
+
+  /**
+   * Fills [first, last) with the next last - first outputs of the engine.
+   * The internal key is computed once, and whole blocks are computed up to
+   * batch_size at a time through the batch bijection of trait_t.
+   */
+  template <std::random_access_iterator iterator_t>
+  requires std::output_iterator<iterator_t, result_t>
+  constexpr void generate(iterator_t first, iterator_t last) noexcept
+  {
+    if (first == last)
+    {
+      return;
+    }
+    const auto remaining = static_cast<size_t>(last - first);
+    detail::for_each_block<trait_t, batch_size>(
+        m_counter, (m_index + remaining + block_size - 1U) / block_size,
+        trait_t::set_key(m_key), [&](const counter_type& block) {
+          const block_type values = reinterpret<result_t>(block);
+          const size_t count = std::min<size_t>(
+              block_size - m_index, static_cast<size_t>(last - first));
+          first = std::copy_n(values.begin() + m_index, count, first);
+          m_index += static_cast<uint32_t>(count);
+          if (m_index == block_size)
+          {
+            m_index = 0U;
+            ++m_counter;
+          }
+        });
+  }
+
+  constexpr void generate(std::span<result_t> values) noexcept
+  {
+    generate(values.begin(), values.end());
+  }
+
+  constexpr key_type key() const noexcept { return m_key; }
+
+  // the counter of the block that holds the next value.
+  constexpr counter_type counter() const noexcept { return m_counter; }
+
+  friend constexpr bool operator==(const compact_counter_engine&,
+                                   const compact_counter_engine&) noexcept =
+      default;
+
+  static constexpr result_t max() noexcept
+  {
+    return std::numeric_limits<result_t>::max();
+  }
+
+  static constexpr result_t min() noexcept
+  {
+    return std::numeric_limits<result_t>::min();
+  }
+};
+
+}  // namespace qtfy::random
+
+#endif
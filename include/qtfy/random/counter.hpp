@@ -1,6 +1,8 @@
 #ifndef QTFY_RANDOM_COUNTER_HPP
 #define QTFY_RANDOM_COUNTER_HPP
 
+#include <climits>
+#include <compare>
 #include "utlities.hpp"
 
 namespace qtfy::random {
@@ -10,7 +12,10 @@ namespace qtfy::random {
  * unsigned integral. The class shares most of the interface that std::array
  * provides in order to access individual elements. Addition and subtraction is
  * supported for integral numbers which allows the class to be used as a
- * counter.
+ * counter. Counters can also be added to, subtracted from and compared with
+ * each other, multiplied by an integral and shifted, all modulo 2 to the power
+ * of the number of bits in the counter, which allows offsets that do not fit
+ * into any integral to be computed, e.g. partition * (counter{1U} << 80U).
  *
  * @tparam word_t
  * The type of the individual words that make up the counter.
@@ -60,6 +65,17 @@ class counter
   template <std::unsigned_integral T>
   constexpr counter &operator-=(T subtrahend) noexcept;
 
+  constexpr counter &operator+=(counter addend) noexcept;
+
+  constexpr counter &operator-=(counter subtrahend) noexcept;
+
+  template <std::unsigned_integral T>
+  constexpr counter &operator*=(T multiplier) noexcept;
+
+  constexpr counter &operator<<=(size_t shift) noexcept;
+
+  constexpr counter &operator>>=(size_t shift) noexcept;
+
   constexpr void fill(word_t value) noexcept
   {
     for (auto &x : m_array)
@@ -134,11 +150,75 @@ class counter
   constexpr const_reference back() const noexcept { return m_array.back(); }
 
   constexpr void swap(counter &right) noexcept { m_array.swap(right.m_array); }
+
+ private:
+  // the native integral that spans the whole counter, if there is one. A
+  // counter with the least significant word first has the same value
+  // representation as that integral on a little endian machine.
+  using wide_t = utilities::wide_word_t<sizeof(array_t)>;
+
+  static constexpr bool has_wide_view =
+      !std::is_void_v<wide_t> && std::endian::native == std::endian::little;
+
+  // stores value word by word. Writing the words individually, rather than
+  // bit casting value back to the array, keeps the compiler from spilling
+  // the integral and reloading it as a vector, which stalls store forwarding.
+  template <class T>
+  constexpr void assign_wide(T value) noexcept
+  {
+    for (size_t i{}; i != words; ++i)
+    {
+      m_array[i] = word_of(value, i);
+    }
+  }
+
+  // the i-th word of value, where word 0 holds the least significant bits.
+  // T may be the 128 bit wide_t, which is not an integral in strict mode.
+  template <class T>
+  static constexpr word_t word_of(T value, size_t i) noexcept
+  {
+    constexpr size_t digits = std::numeric_limits<word_t>::digits;
+    if (i * digits >= sizeof(T) * CHAR_BIT)
+    {
+      return word_t{};
+    }
+    return static_cast<word_t>(value >> (i * digits));
+  }
+
+  template <std::unsigned_integral T>
+  constexpr void add_carry_chain(T addend) noexcept
+  {
+    bool carry{};
+    for (size_t i{}; i != words; ++i)
+    {
+      m_array[i] =
+          utilities::add_with_carry(m_array[i], word_of(addend, i), carry);
+    }
+  }
+
+  template <std::unsigned_integral T>
+  constexpr void subtract_borrow_chain(T subtrahend) noexcept
+  {
+    bool borrow{};
+    for (size_t i{}; i != words; ++i)
+    {
+      m_array[i] = utilities::subtract_with_borrow(
+          m_array[i], word_of(subtrahend, i), borrow);
+    }
+  }
 };
 
 template <std::unsigned_integral word_t, size_t words>
 constexpr counter<word_t, words> &counter<word_t, words>::operator++() noexcept
 {
+  if constexpr (has_wide_view)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      assign_wide(std::bit_cast<wide_t>(m_array) + 1U);
+      return *this;
+    }
+  }
   for (size_t i{0U}; ++m_array[i] == word_t{} && ++i != words;)
   {
   }
@@ -148,6 +228,14 @@ constexpr counter<word_t, words> &counter<word_t, words>::operator++() noexcept
 template <std::unsigned_integral word_t, size_t words>
 constexpr counter<word_t, words> &counter<word_t, words>::operator--() noexcept
 {
+  if constexpr (has_wide_view)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      assign_wide(std::bit_cast<wide_t>(m_array) - 1U);
+      return *this;
+    }
+  }
   constexpr auto max = std::numeric_limits<word_t>::max();
   for (size_t i{}; --m_array[i] == max && ++i != words;)
   {
@@ -176,6 +264,24 @@ constexpr bool operator!=(counter<word_t, words> left,
   return left.m_array != right.m_array;
 }
 
+/**
+ * Orders counters by their value, i.e. starting from the most significant
+ * word, which is the last one.
+ */
+template <std::unsigned_integral word_t, size_t words>
+constexpr std::strong_ordering operator<=>(counter<word_t, words> left,
+                                           counter<word_t, words> right) noexcept
+{
+  for (size_t i{words}; i-- != 0U;)
+  {
+    if (left[i] != right[i])
+    {
+      return left[i] <=> right[i];
+    }
+  }
+  return std::strong_ordering::equal;
+}
+
 template <std::unsigned_integral word_t, size_t words, std::unsigned_integral T>
 constexpr counter<word_t, words> operator+(counter<word_t, words> left,
                                            T addend) noexcept
@@ -183,6 +289,48 @@ constexpr counter<word_t, words> operator+(counter<word_t, words> left,
   return left += addend;
 }
 
+template <std::unsigned_integral word_t, size_t words>
+constexpr counter<word_t, words> operator+(
+    counter<word_t, words> left, counter<word_t, words> right) noexcept
+{
+  return left += right;
+}
+
+template <std::unsigned_integral word_t, size_t words>
+constexpr counter<word_t, words> operator-(
+    counter<word_t, words> left, counter<word_t, words> right) noexcept
+{
+  return left -= right;
+}
+
+template <std::unsigned_integral word_t, size_t words, std::unsigned_integral T>
+constexpr counter<word_t, words> operator*(counter<word_t, words> left,
+                                           T multiplier) noexcept
+{
+  return left *= multiplier;
+}
+
+template <std::unsigned_integral word_t, size_t words, std::unsigned_integral T>
+constexpr counter<word_t, words> operator*(T multiplier,
+                                           counter<word_t, words> right) noexcept
+{
+  return right *= multiplier;
+}
+
+template <std::unsigned_integral word_t, size_t words>
+constexpr counter<word_t, words> operator<<(counter<word_t, words> left,
+                                            size_t shift) noexcept
+{
+  return left <<= shift;
+}
+
+template <std::unsigned_integral word_t, size_t words>
+constexpr counter<word_t, words> operator>>(counter<word_t, words> left,
+                                            size_t shift) noexcept
+{
+  return left >>= shift;
+}
+
 template <std::unsigned_integral word_t, size_t words, std::unsigned_integral T>
 constexpr counter<word_t, words> operator-(counter<word_t, words> left,
                                            T subtrahend) noexcept
@@ -195,14 +343,24 @@ template <std::unsigned_integral T>
 constexpr counter<word_t, words> &counter<word_t, words>::operator+=(
     T addend) noexcept
 {
-  // TODO: can we reinterpret this as a either
-  // 1) a counter with a single integral
-  // 2) a counter with a larger word type so that a more optimal
-  //    algorithm can be used
-  // *) do we need to align counters to the alignment of uintmax_t?
+  // at runtime a counter that fits a native integral is added to as that
+  // integral, and any other counter propagates the carry through every word
+  // without branching on it. The loops below remain for constant evaluation.
   if constexpr (words == 1U)
   {
     m_array[0U] += addend;
+    return *this;
+  }
+  else if (!std::is_constant_evaluated())
+  {
+    if constexpr (has_wide_view)
+    {
+      assign_wide(std::bit_cast<wide_t>(m_array) + static_cast<wide_t>(addend));
+    }
+    else
+    {
+      add_carry_chain(addend);
+    }
   }
   else if constexpr (sizeof(T) <= sizeof(word_t))
   {
@@ -241,6 +399,19 @@ constexpr counter<word_t, words> &counter<word_t, words>::operator-=(
   if constexpr (words == 1U)
   {
     m_array[0U] -= subtrahend;
+    return *this;
+  }
+  else if (!std::is_constant_evaluated())
+  {
+    if constexpr (has_wide_view)
+    {
+      assign_wide(std::bit_cast<wide_t>(m_array) -
+                  static_cast<wide_t>(subtrahend));
+    }
+    else
+    {
+      subtract_borrow_chain(subtrahend);
+    }
   }
   else if constexpr (sizeof(T) <= sizeof(word_t))
   {
@@ -272,6 +443,142 @@ constexpr counter<word_t, words> &counter<word_t, words>::operator-=(
   return *this;
 }
 
+template <std::unsigned_integral word_t, size_t words>
+constexpr counter<word_t, words> &counter<word_t, words>::operator+=(
+    counter addend) noexcept
+{
+  if constexpr (has_wide_view)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      assign_wide(std::bit_cast<wide_t>(m_array) +
+                  std::bit_cast<wide_t>(addend.m_array));
+      return *this;
+    }
+  }
+  bool carry{};
+  for (size_t i{}; i != words; ++i)
+  {
+    m_array[i] = utilities::add_with_carry(m_array[i], addend[i], carry);
+  }
+  return *this;
+}
+
+template <std::unsigned_integral word_t, size_t words>
+constexpr counter<word_t, words> &counter<word_t, words>::operator-=(
+    counter subtrahend) noexcept
+{
+  if constexpr (has_wide_view)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      assign_wide(std::bit_cast<wide_t>(m_array) -
+                  std::bit_cast<wide_t>(subtrahend.m_array));
+      return *this;
+    }
+  }
+  bool borrow{};
+  for (size_t i{}; i != words; ++i)
+  {
+    m_array[i] =
+        utilities::subtract_with_borrow(m_array[i], subtrahend[i], borrow);
+  }
+  return *this;
+}
+
+/**
+ * Multiplies the counter by multiplier modulo 2 to the power of the number of
+ * bits in the counter. Every word of the multiplier is applied with a single
+ * pass of full word products over the counter.
+ */
+template <std::unsigned_integral word_t, size_t words>
+template <std::unsigned_integral T>
+constexpr counter<word_t, words> &counter<word_t, words>::operator*=(
+    T multiplier) noexcept
+{
+  if constexpr (has_wide_view)
+  {
+    if (!std::is_constant_evaluated())
+    {
+      assign_wide(std::bit_cast<wide_t>(m_array) *
+                  static_cast<wide_t>(multiplier));
+      return *this;
+    }
+  }
+  const array_t multiplicand = m_array;
+  fill(word_t{});
+  for (size_t j{}; j != words; ++j)
+  {
+    const word_t factor = word_of(multiplier, j);
+    if (factor == word_t{})
+    {
+      continue;
+    }
+    // product.hi + both carries cannot overflow, since the largest possible
+    // sum of a full product and two words still fits into two words.
+    word_t carry{};
+    for (size_t i{}; i + j != words; ++i)
+    {
+      const auto product = utilities::big_mul(multiplicand[i], factor);
+      bool carry_lo{};
+      const word_t lo = utilities::add_with_carry(product.lo, carry, carry_lo);
+      bool carry_sum{};
+      m_array[i + j] =
+          utilities::add_with_carry(m_array[i + j], lo, carry_sum);
+      carry = static_cast<word_t>(product.hi + carry_lo + carry_sum);
+    }
+  }
+  return *this;
+}
+
+template <std::unsigned_integral word_t, size_t words>
+constexpr counter<word_t, words> &counter<word_t, words>::operator<<=(
+    size_t shift) noexcept
+{
+  constexpr size_t digits = std::numeric_limits<word_t>::digits;
+  const size_t word_shift = shift / digits;
+  const size_t bit_shift = shift % digits;
+  for (size_t i{words}; i-- != 0U;)
+  {
+    word_t value{};
+    if (i >= word_shift)
+    {
+      value = static_cast<word_t>(m_array[i - word_shift] << bit_shift);
+      if (bit_shift != 0U && i > word_shift)
+      {
+        value |= static_cast<word_t>(m_array[i - word_shift - 1U] >>
+                                     (digits - bit_shift));
+      }
+    }
+    m_array[i] = value;
+  }
+  return *this;
+}
+
+template <std::unsigned_integral word_t, size_t words>
+constexpr counter<word_t, words> &counter<word_t, words>::operator>>=(
+    size_t shift) noexcept
+{
+  constexpr size_t digits = std::numeric_limits<word_t>::digits;
+  const size_t word_shift = shift / digits;
+  const size_t bit_shift = shift % digits;
+  for (size_t i{}; i != words; ++i)
+  {
+    word_t value{};
+    if (word_shift < words - i)
+    {
+      value = static_cast<word_t>(m_array[i + word_shift] >> bit_shift);
+      if (bit_shift != 0U && word_shift + 1U < words - i)
+      {
+        value |= static_cast<word_t>(m_array[i + word_shift + 1U]
+                                     << (digits - bit_shift));
+      }
+    }
+    m_array[i] = value;
+  }
+  return *this;
+}
+
 template <std::unsigned_integral new_word_t,
           std::unsigned_integral old_word_t,
           size_t old_count>
@@ -1,28 +1,253 @@
 #ifndef QTFY_RANDOM_COUNTER_BASED_ENGINE_HPP
 #define QTFY_RANDOM_COUNTER_BASED_ENGINE_HPP
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 #include "counter.hpp"
 
 namespace qtfy::random {
 
+/**
+ * The interval that canonical floating point values are mapped into.
+ * The open variants never return zero, which makes them suitable as input to
+ * log or inverse cumulative distribution functions without rejection.
+ */
+enum class canonical_interval
+{
+  closed_open,  // [0, 1)
+  open_closed,  // (0, 1]
+  open_open     // (0, 1)
+};
+
+namespace detail {
+
+template <class trait_t>
+inline constexpr bool has_bijection_batch =
+    requires(std::span<const typename trait_t::counter_type> counters,
+             std::span<typename trait_t::counter_type> results,
+             typename trait_t::internal_key_type key)
+{
+  trait_t::bijection_batch(counters, results, key);
+};
+
+// applies the bijection to every counter in counters, through the batch
+// bijection of trait_t when it has one.
+template <class trait_t>
+constexpr void bijection_batch(
+    std::span<const typename trait_t::counter_type> counters,
+    std::span<typename trait_t::counter_type> results,
+    const typename trait_t::internal_key_type& key) noexcept
+{
+  if constexpr (has_bijection_batch<trait_t>)
+  {
+    trait_t::bijection_batch(counters, results, key);
+  }
+  else
+  {
+    for (size_t i{}; i < counters.size(); ++i)
+    {
+      results[i] = trait_t::bijection(counters[i], key);
+    }
+  }
+}
+
+/**
+ * Passes the output of the bijection for blocks consecutive counters,
+ * starting at ctr, to f in order. The counters are handed to bijection_batch
+ * batch_size at a time. A single block, as refilled by engines of depth one,
+ * goes straight to the scalar bijection, since dispatching it to a simd
+ * kernel costs more than the bijection.
+ */
+template <class trait_t, size_t batch_size, class F>
+constexpr void for_each_block(typename trait_t::counter_type ctr,
+                              uint64_t blocks,
+                              const typename trait_t::internal_key_type& key,
+                              F&& f) noexcept
+{
+  using counter_type = typename trait_t::counter_type;
+  if (blocks == 1U)
+  {
+    f(trait_t::bijection(ctr, key));
+    return;
+  }
+  std::array<counter_type, batch_size> counters{};
+  std::array<counter_type, batch_size> results{};
+  while (blocks != 0U)
+  {
+    const auto count =
+        static_cast<size_t>(std::min<uint64_t>(blocks, batch_size));
+    for (size_t i{}; i < count; ++i)
+    {
+      counters[i] = ctr;
+      ++ctr;
+    }
+    bijection_batch<trait_t>({counters.data(), count},
+                             {results.data(), count}, key);
+    for (size_t i{}; i < count; ++i)
+    {
+      f(results[i]);
+    }
+    blocks -= count;
+  }
+}
+
+}  // namespace detail
+
+/**
+ * A uniform random bit generator that draws its values from the bijection of
+ * trait_t applied to consecutive counters.
+ *
+ * @tparam depth
+ * The number of blocks, i.e. bijection outputs, that are buffered. Each
+ * refill computes depth consecutive counters in a single batched call, which
+ * makes refills rarer and lets them use the multi lane kernels. The sequence
+ * of values does not depend on depth.
+ *
+ * @tparam stream_bits
+ * The number of high counter bits that hold the id of a substream, see
+ * substream(). Only substreams have a non zero stream_bits, so the state of
+ * any other engine holds no stream id.
+ */
 template <class trait_t,
-          std::unsigned_integral result_t = typename trait_t::word_type>
+          std::unsigned_integral result_t = typename trait_t::word_type,
+          size_t depth = 1U, size_t stream_bits = 0U>
 class counter_based_engine
 {
+  static_assert(depth != 0U);
+
+  template <class, std::unsigned_integral, size_t, size_t>
+  friend class counter_based_engine;
+
  public:
+  using trait_type = trait_t;
+  using result_type = result_t;
   using word_type = typename trait_t::word_type;
   using key_type = typename trait_t::key_type;
   using counter_type = typename trait_t::counter_type;
   using internal_key_type = typename trait_t::internal_key_type;
-  using buffer_type =
+  using block_type =
       decltype(reinterpret<result_t>(trait_t::bijection({}, {})));
 
  private:
-  static constexpr size_t buffer_size = buffer_type{}.size();
+  static constexpr size_t block_size = block_type{}.size();
+  static constexpr size_t buffer_size = depth * block_size;
+  static constexpr size_t batch_size = depth < 16U ? 16U : depth;
+  static constexpr size_t counter_bits =
+      counter_type{}.size() * std::numeric_limits<word_type>::digits;
+
+ public:
+  using buffer_type = std::array<result_t, buffer_size>;
+
+ private:
   size_t m_index{};
   buffer_type m_buffer{};
+  // the counter of the first block in m_buffer.
   counter_type m_counter{};
-  const internal_key_type m_key{};
+  // empty for traits whose key is fixed at compile time.
+  [[no_unique_address]] internal_key_type m_key{};
+  struct no_stream_id
+  {
+  };
+  using stream_id_type =
+      std::conditional_t<stream_bits != 0U, uint64_t, no_stream_id>;
+  // the id in the stream_bits highest bits of m_counter.
+  [[no_unique_address]] stream_id_type m_stream_id{};
+
+  // passes the blocks of blocks consecutive counters, starting at ctr, to f
+  // in order, see detail::for_each_block.
+  template <class F>
+  constexpr void for_each_block(counter_type ctr, size_t blocks,
+                                F&& f) const noexcept
+  {
+    detail::for_each_block<trait_t, batch_size>(
+        ctr, blocks, m_key, [&f](const counter_type& block) {
+          f(reinterpret<result_t>(block));
+        });
+  }
+
+  // the counter of the block that holds the value n draws after the next
+  // one, together with the index of that value within the block.
+  constexpr std::pair<counter_type, size_t> locate(
+      unsigned long long n) const noexcept
+  {
+    const size_t offset =
+        m_index % block_size + static_cast<size_t>(n % block_size);
+    counter_type ctr = m_counter;
+    ctr += m_index / block_size + offset / block_size;
+    ctr += n / block_size;
+    return {ctr, offset % block_size};
+  }
+
+  // writes the values.size() consecutive values that start n draws after
+  // the next one to values, computing each block that they span once.
+  constexpr void copy_at(unsigned long long n,
+                         std::span<result_t> values) const noexcept
+  {
+    if (n < buffer_size - m_index &&
+        values.size() <= buffer_size - m_index - n)
+    {
+      std::copy_n(m_buffer.begin() + static_cast<std::ptrdiff_t>(m_index + n),
+                  values.size(), values.begin());
+      return;
+    }
+    const auto [ctr, offset] = locate(n);
+    copy_blocks(m_key, ctr, offset, values);
+  }
+
+  // writes the values.size() consecutive values that start at value offset
+  // of the block at ctr to values, computing each block that they span once.
+  static constexpr void copy_blocks(internal_key_type key, counter_type ctr,
+                                    size_t offset,
+                                    std::span<result_t> values) noexcept
+  {
+    for (size_t i{}; i != values.size(); offset = 0U, ++ctr)
+    {
+      const block_type block = bijection(ctr, key);
+      for (; offset != block_size && i != values.size(); ++offset, ++i)
+      {
+        values[i] = block[offset];
+      }
+    }
+  }
+
+  // the engine at counter with its internal key already set.
+  constexpr counter_based_engine(internal_key_type key, counter_type counter,
+                                 stream_id_type stream_id) noexcept
+      : m_index{}, m_buffer{}, m_counter{counter}, m_key{key},
+        m_stream_id{stream_id}
+  {
+    refill();
+  }
+
+  // in debug builds, checks that the block of the last value drawn from the
+  // buffer, if any, still belongs to the stream of a substream. The buffer
+  // may hold blocks of the next stream as long as none of their values is
+  // drawn.
+  constexpr void check_stream() const noexcept
+  {
+    if constexpr (stream_bits != 0U)
+    {
+      assert((m_index == 0U ||
+              ((m_counter + (m_index - 1U) / block_size) >>
+               (counter_bits - stream_bits)) ==
+                  counter_type{} + m_stream_id) &&
+             "substream has run into the next stream");
+    }
+  }
+
+  // fills m_buffer with the depth blocks that start at m_counter.
+  constexpr void refill() noexcept
+  {
+    auto out = m_buffer.begin();
+    for_each_block(m_counter, depth, [&out](const block_type& block) {
+      out = std::copy(block.begin(), block.end(), out);
+    });
+  }
 
  public:
   static constexpr internal_key_type set_key(key_type key) noexcept
@@ -30,7 +255,7 @@ class counter_based_engine
     return trait_t::set_key(key);
   }
 
-  static constexpr buffer_type bijection(
+  static constexpr block_type bijection(
       counter_type counter, internal_key_type internal_key) noexcept
   {
     return reinterpret<result_t>(trait_t::bijection(counter, internal_key));
@@ -39,7 +264,7 @@ class counter_based_engine
   constexpr counter_based_engine(key_type key, counter_type counter) noexcept
       : m_index{}, m_buffer{}, m_counter{counter}, m_key{set_key(key)}
   {
-    m_buffer = bijection(m_counter, m_key);
+    refill();
   }
 
   explicit constexpr counter_based_engine(key_type key) noexcept
@@ -52,6 +277,55 @@ class counter_based_engine
   {
   }
 
+  /**
+   * Returns an engine with the same key whose counter holds stream_id in its
+   * bits highest bits and zero in the rest, which count the blocks within
+   * the stream. Distinct ids therefore give non overlapping streams of
+   * pow(2, counter bits - bits) blocks each. The key is not set again, so
+   * creating a substream costs a single refill. The substream keeps its id,
+   * and debug builds check that no value it draws belongs to the next
+   * stream.
+   *
+   * @tparam min_position_bits
+   * The smallest number of bits that must remain for the position within a
+   * stream, so that substreams of traits with short counters fail to
+   * compile instead of silently having a short period.
+   */
+  template <size_t bits, size_t min_position_bits = 32U>
+  constexpr counter_based_engine<trait_t, result_t, depth, bits> substream(
+      uint64_t stream_id) const noexcept
+  {
+    static_assert(bits != 0U && bits <= 64U, "the stream id is a uint64_t");
+    static_assert(counter_bits >= bits + min_position_bits,
+                  "the counter is too short for streams of this period");
+    if constexpr (bits < 64U)
+    {
+      assert(stream_id >> bits == 0U &&
+             "stream_id does not fit into bits");
+    }
+    return {m_key, (counter_type{} + stream_id) << (counter_bits - bits),
+            stream_id};
+  }
+
+  /**
+   * Returns an engine with the same key and the tweak replaced by tweak,
+   * positioned at the first block of its stream. For traits with a runtime
+   * tweak every tweak selects an independent stream that covers the whole
+   * counter space, and switching to it neither sets the key again nor
+   * partitions the counter as substream does.
+   */
+  template <class T = trait_t>
+  requires requires(typename T::internal_key_type key,
+                    typename T::tweak_type tweak)
+  {
+    T::set_tweak(key, tweak);
+  }
+  constexpr counter_based_engine<trait_t, result_t, depth> with_tweak(
+      typename T::tweak_type tweak) const noexcept
+  {
+    return {trait_t::set_tweak(m_key, tweak), counter_type{}, {}};
+  }
+
   constexpr void discard(unsigned long long steps) noexcept
   {
     auto chunks = steps / buffer_size;
@@ -63,8 +337,34 @@ class counter_based_engine
     }
     if (chunks != 0U)
     {
-      m_counter += chunks;
-      m_buffer = bijection(m_counter, m_key);
+      m_counter += chunks * depth;
+      refill();
+    }
+  }
+
+  /**
+   * Discards blocks whole blocks, i.e. outputs of the bijection, followed by
+   * intra_block values. This reaches positions that steps cannot express,
+   * such as the start of a partition of a four word counter, in the same
+   * time as a short jump.
+   */
+  constexpr void discard(counter_type blocks, size_t intra_block) noexcept
+  {
+    const size_t offset = m_index % block_size + intra_block % block_size;
+    counter_type target = m_counter + blocks;
+    target += m_index / block_size + intra_block / block_size +
+              offset / block_size;
+    const counter_type ahead = target - m_counter;
+    if (ahead < counter_type{} + depth)
+    {
+      m_index = static_cast<size_t>(ahead[0U]) * block_size +
+                offset % block_size;
+    }
+    else
+    {
+      m_counter = target;
+      refill();
+      m_index = offset % block_size;
     }
   }
 
@@ -72,10 +372,112 @@ class counter_based_engine
   {
     if (m_index == buffer_size)
     {
-      m_buffer = bijection(++m_counter, m_key);
+      m_counter += depth;
+      refill();
       m_index = size_t{};
     }
-    return m_buffer[m_index++];
+    const result_t value = m_buffer[m_index++];
+    check_stream();
+    return value;
+  }
+
+  /**
+   * Fills [first, last) with the next last - first outputs of the engine.
+   * The remainder of the current buffer is drained first, after which whole
+   * blocks are written straight from the bijection into the output. The
+   * engine is left in the same state as after last - first calls to
+   * operator().
+   */
+  template <std::random_access_iterator iterator_t>
+  requires std::output_iterator<iterator_t, result_t>
+  constexpr void generate(iterator_t first, iterator_t last) noexcept
+  {
+    while (m_index != buffer_size && first != last)
+    {
+      *first++ = m_buffer[m_index++];
+    }
+
+    auto remaining = static_cast<size_t>(last - first);
+    if (remaining == 0U)
+    {
+      check_stream();
+      return;
+    }
+
+    // the final buffer is always refilled so that the engine ends up in the
+    // same state as it would after the scalar calls.
+    const size_t buffers = (remaining - 1U) / buffer_size;
+    for_each_block(m_counter + depth, buffers * depth,
+                   [&first](const block_type& block) {
+                     first = std::copy(block.begin(), block.end(), first);
+                   });
+    remaining -= buffers * buffer_size;
+
+    m_counter += (buffers + 1U) * depth;
+    refill();
+    std::copy_n(m_buffer.begin(), remaining, first);
+    m_index = remaining;
+    check_stream();
+  }
+
+  constexpr void generate(std::span<result_t> values) noexcept
+  {
+    generate(values.begin(), values.end());
+  }
+
+  /**
+   * Returns the value that operator() would return after n further calls,
+   * i.e. at(0) is the next value, without changing the state of the engine.
+   * Since the bijection is stateless, this costs at most a single bijection
+   * no matter how large n is.
+   */
+  constexpr result_t at(unsigned long long n) const noexcept
+  {
+    if (n < buffer_size - m_index)
+    {
+      return m_buffer[m_index + static_cast<size_t>(n)];
+    }
+    const auto [ctr, offset] = locate(n);
+    return bijection(ctr, m_key)[offset];
+  }
+
+  /**
+   * Returns the n-th value, counting from zero, of an engine constructed
+   * from key and counter.
+   */
+  static constexpr result_t draw_at(key_type key, counter_type counter,
+                                    unsigned long long n) noexcept
+  {
+    counter += n / block_size;
+    return bijection(counter, set_key(key))[n % block_size];
+  }
+
+  /**
+   * Writes at(indices[i]) to values[i] for every index, which must have at
+   * least as many elements as indices. The blocks of up to batch_size
+   * indices at a time are computed in a single batched bijection, so sparse
+   * lookups use the multi lane kernels as well.
+   */
+  constexpr void gather(std::span<const uint64_t> indices,
+                        std::span<result_t> values) const noexcept
+  {
+    std::array<counter_type, batch_size> counters{};
+    std::array<counter_type, batch_size> results{};
+    std::array<size_t, batch_size> offsets{};
+    for (size_t first{}; first < indices.size(); first += batch_size)
+    {
+      const size_t count = std::min(indices.size() - first, batch_size);
+      for (size_t i{}; i < count; ++i)
+      {
+        std::tie(counters[i], offsets[i]) = locate(indices[first + i]);
+      }
+      detail::bijection_batch<trait_t>({counters.data(), count},
+                                       {results.data(), count}, m_key);
+      for (size_t i{}; i < count; ++i)
+      {
+        values[first + i] = reinterpret<result_t>(results[i])[offsets[i]];
+      }
+    }
   }
 
   static constexpr result_t max() noexcept
@@ -96,15 +498,15 @@ class counter_based_engine
     {
       return uint8_t{x};
     }
-    if constexpr (required_bits <= 16)
+    else if constexpr (required_bits <= 16)
     {
       return uint16_t{x};
     }
-    if constexpr (required_bits <= 32)
+    else if constexpr (required_bits <= 32)
     {
       return uint32_t{x};
     }
-    if constexpr (required_bits <= 64)
+    else
     {
       return uint64_t{x};
     }
@@ -122,53 +524,220 @@ class counter_based_engine
   };
 
   template <size_t required_bits>
-  requires(required_bits <= 64) constexpr auto get_bits() noexcept
+  static constexpr size_t required_draws =
+      (required_bits + std::numeric_limits<result_t>::digits - 1U) /
+      std::numeric_limits<result_t>::digits;
+
+  template <std::floating_point T, unsigned bits>
+  static constexpr size_t canonical_bits =
+      bits <= std::numeric_limits<T>::digits ? bits
+                                             : std::numeric_limits<T>::digits;
+
+  /**
+   * Combines required_draws<required_bits> consecutive draws into a single
+   * integral holding required_bits random bits. This is the one place that
+   * defines how draws are packed, so that the scalar and the bulk canonical
+   * paths produce the same sequence.
+   */
+  template <size_t required_bits>
+  requires(required_bits <= 64) static constexpr auto combine_bits(
+      const result_t* draws) noexcept
   {
     using return_t = decltype(init_int<required_bits>(0U));
     constexpr size_t bits_per_draw = std::numeric_limits<result_t>::digits;
-    constexpr size_t required_draws = required_bits % bits_per_draw == 0U
-                                          ? required_bits / bits_per_draw
-                                          : required_bits / bits_per_draw + 1;
+    constexpr size_t draw_count = required_draws<required_bits>;
+    constexpr size_t shift = draw_count * bits_per_draw - required_bits;
 
-    constexpr size_t shift = required_draws * bits_per_draw - required_bits;
-    if constexpr (required_bits <= bits_per_draw)
+    if constexpr (draw_count == 1U)
     {
-      return operator()() >> shift;
+      return static_cast<return_t>(draws[0U] >> shift);
     }
-
-    constexpr bool experimental = true;
-    if constexpr (std::endian::native == std::endian::little && experimental)
+    else if constexpr (std::endian::native == std::endian::little)
     {
-      using sub_t = decltype(operator()());
-      using alias_t = alias<return_t, sub_t>;
+      using alias_t = alias<return_t, result_t>;
       alias_t a{};
-      for (size_t i{}; i < required_draws; ++i)
+      for (size_t i{}; i < draw_count; ++i)
       {
-        a.parts[i] = operator()();
+        a.parts[i] = draws[i];
       }
-      return std::bit_cast<return_t>(a) >> shift;
+      return static_cast<return_t>(std::bit_cast<return_t>(a) >> shift);
     }
     else
     {
-      auto result = init_int<required_bits>(operator()());
-      for (size_t i{1}; i < required_draws; ++i)
+      return_t result = draws[0U];
+      for (size_t i{1}; i < draw_count; ++i)
       {
         result <<= bits_per_draw;
-        result += operator()();
+        result += draws[i];
       }
 
-      return result >> shift;
+      return static_cast<return_t>(result >> shift);
+    }
+  }
+
+  template <size_t required_bits>
+  requires(required_bits <= 64) constexpr auto get_bits() noexcept
+  {
+    std::array<result_t, required_draws<required_bits>> draws{};
+    for (auto& draw : draws)
+    {
+      draw = operator()();
+    }
+    return combine_bits<required_bits>(draws.data());
+  }
+
+  template <std::floating_point T, size_t scale>
+  static consteval T inverse_power_of_two() noexcept
+  {
+    T result{1};
+    for (size_t i{}; i < scale; ++i)
+    {
+      result /= T{2};
+    }
+    return result;
+  }
+
+  /**
+   * Maps scale random bits onto the requested interval with a single
+   * multiplication by the exact constant pow(2, -scale). For the open
+   * interval the lowest bit is forced to one, which gives the midpoints of
+   * pow(2, scale - 1) equally sized sub intervals.
+   */
+  template <std::floating_point T, size_t scale, canonical_interval interval>
+  static constexpr T to_canonical(std::unsigned_integral auto x) noexcept
+  {
+    constexpr T factor = inverse_power_of_two<T, scale>();
+    if constexpr (interval == canonical_interval::closed_open)
+    {
+      return static_cast<T>(x) * factor;
+    }
+    else if constexpr (interval == canonical_interval::open_closed)
+    {
+      return (static_cast<T>(x) + T{1}) * factor;
+    }
+    else
+    {
+      return static_cast<T>(x | 1U) * factor;
     }
   }
 
  public:
   template <std::floating_point T = double,
-            unsigned bits = std::numeric_limits<T>::digits>
+            unsigned bits = std::numeric_limits<T>::digits,
+            canonical_interval interval = canonical_interval::closed_open>
   constexpr T next_canonical() noexcept
   {
-    constexpr auto digits = std::numeric_limits<T>::digits;
-    constexpr int scale = bits <= digits ? bits : digits;
-    return std::scalbn(static_cast<T>(get_bits<scale>()), -scale);
+    constexpr auto scale = canonical_bits<T, bits>;
+    return to_canonical<T, scale, interval>(get_bits<scale>());
+  }
+
+  /**
+   * Returns the value that next_canonical<T, bits, interval>() would return
+   * after n further calls to it, without changing the state of the engine.
+   */
+  template <std::floating_point T = double,
+            unsigned bits = std::numeric_limits<T>::digits,
+            canonical_interval interval = canonical_interval::closed_open>
+  constexpr T next_canonical_at(unsigned long long n) const noexcept
+  {
+    constexpr auto scale = canonical_bits<T, bits>;
+    std::array<result_t, required_draws<scale>> draws{};
+    copy_at(n * draws.size(), draws);
+    return to_canonical<T, scale, interval>(combine_bits<scale>(draws.data()));
+  }
+
+  /**
+   * Returns the value that next_canonical<T, bits, interval>() returns after
+   * n calls to it on an engine whose internal key is internal_key and whose
+   * first value is the first of the block at counter. Views over a stream
+   * use this to compute canonical values from the key and counter alone.
+   */
+  template <std::floating_point T = double,
+            unsigned bits = std::numeric_limits<T>::digits,
+            canonical_interval interval = canonical_interval::closed_open>
+  static constexpr T canonical_at(internal_key_type internal_key,
+                                  counter_type counter,
+                                  unsigned long long n) noexcept
+  {
+    constexpr auto scale = canonical_bits<T, bits>;
+    std::array<result_t, required_draws<scale>> draws{};
+    const unsigned long long first = n * draws.size();
+    counter += first / block_size;
+    copy_blocks(internal_key, counter,
+                static_cast<size_t>(first % block_size), draws);
+    return to_canonical<T, scale, interval>(combine_bits<scale>(draws.data()));
+  }
+
+  /**
+   * Fills values with the same sequence that repeated calls to
+   * next_canonical<T, bits, interval>() would produce. When a value is made up of a
+   * whole number of draws per block, complete blocks are converted in one
+   * pass without going through the buffer.
+   *
+   * @note
+   * A value takes as many draws as are needed to hold its bits, so a
+   * uint32_t engine pairs words into 53 bit doubles and a uint32_t view of a
+   * 64 bit trait (e.g. threefry4x64<uint32_t>) splits each 64 bit word into
+   * two floats.
+   */
+  template <std::floating_point T = double,
+            unsigned bits = std::numeric_limits<T>::digits,
+            canonical_interval interval = canonical_interval::closed_open>
+  constexpr void fill_canonical(std::span<T> values) noexcept
+  {
+    constexpr auto scale = canonical_bits<T, bits>;
+    constexpr size_t draws = required_draws<scale>;
+
+    if constexpr (block_size % draws == 0U)
+    {
+      constexpr size_t values_per_block = block_size / draws;
+      constexpr size_t values_per_buffer = buffer_size / draws;
+
+      if (m_index % draws == 0U)
+      {
+        auto first = values.begin();
+        const auto last = values.end();
+        auto convert = [&first](const result_t* block, size_t count) {
+          for (size_t i{}; i < count; ++i)
+          {
+            *first++ = to_canonical<T, scale, interval>(
+                combine_bits<scale>(block + i * draws));
+          }
+        };
+
+        for (; m_index != buffer_size && first != last; m_index += draws)
+        {
+          *first++ = to_canonical<T, scale, interval>(
+              combine_bits<scale>(m_buffer.data() + m_index));
+        }
+
+        auto remaining = static_cast<size_t>(last - first);
+        if (remaining == 0U)
+        {
+          check_stream();
+          return;
+        }
+
+        const size_t buffers = (remaining - 1U) / values_per_buffer;
+        for_each_block(m_counter + depth, buffers * depth,
+                       [&convert](const block_type& block) {
+                         convert(block.data(), values_per_block);
+                       });
+        remaining -= buffers * values_per_buffer;
+
+        m_counter += (buffers + 1U) * depth;
+        refill();
+        convert(m_buffer.data(), remaining);
+        m_index = remaining * draws;
+        check_stream();
+        return;
+      }
+    }
+
+    for (auto& value : values)
+    {
+      value = next_canonical<T, bits, interval>();
+    }
   }
 };
 
@@ -0,0 +1,257 @@
+#ifndef QTFY_RANDOM_COUNTER_STREAM_VIEW_HPP
+#define QTFY_RANDOM_COUNTER_STREAM_VIEW_HPP
+
+#include <compare>
+#include <iterator>
+#include <ranges>
+#include "counter_based_engine.hpp"
+
+namespace qtfy::random {
+
+/**
+ * A random access iterator over an infinite stream whose i-th element is
+ * view_t::value_at(i). Elements are computed on dereference, so the
+ * iterator can be advanced by any distance in constant time, and iterators
+ * of the same view can be handed to different threads without coordination.
+ * The iterator holds a copy of the view, which consists of a key and a
+ * counter, so it stays valid after the view it came from is destroyed.
+ *
+ * @note
+ * Dereferencing returns by value, like the iterator of std::views::iota.
+ * As there, iterator_concept is random access while iterator_category is
+ * input, since the legacy forward iterator requirements demand a reference.
+ */
+template <class view_t, class value_t>
+class stream_iterator
+{
+  view_t m_view{};
+  uint64_t m_index{};
+
+ public:
+  using value_type = value_t;
+  using reference = value_t;
+  using difference_type = std::ptrdiff_t;
+  using iterator_concept = std::random_access_iterator_tag;
+  using iterator_category = std::input_iterator_tag;
+
+  constexpr stream_iterator() noexcept = default;
+
+  constexpr stream_iterator(const view_t& view, uint64_t index) noexcept
+      : m_view{view}, m_index{index}
+  {
+  }
+
+  constexpr value_t operator*() const noexcept
+  {
+    return m_view.value_at(m_index);
+  }
+
+  constexpr value_t operator[](difference_type n) const noexcept
+  {
+    return *(*this + n);
+  }
+
+  constexpr uint64_t index() const noexcept { return m_index; }
+
+  constexpr stream_iterator& operator++() noexcept
+  {
+    ++m_index;
+    return *this;
+  }
+
+  constexpr stream_iterator operator++(int) noexcept
+  {
+    auto result = *this;
+    ++m_index;
+    return result;
+  }
+
+  constexpr stream_iterator& operator--() noexcept
+  {
+    --m_index;
+    return *this;
+  }
+
+  constexpr stream_iterator operator--(int) noexcept
+  {
+    auto result = *this;
+    --m_index;
+    return result;
+  }
+
+  constexpr stream_iterator& operator+=(difference_type n) noexcept
+  {
+    m_index += static_cast<uint64_t>(n);
+    return *this;
+  }
+
+  constexpr stream_iterator& operator-=(difference_type n) noexcept
+  {
+    m_index -= static_cast<uint64_t>(n);
+    return *this;
+  }
+
+  friend constexpr stream_iterator operator+(stream_iterator it,
+                                             difference_type n) noexcept
+  {
+    return it += n;
+  }
+
+  friend constexpr stream_iterator operator+(difference_type n,
+                                             stream_iterator it) noexcept
+  {
+    return it += n;
+  }
+
+  friend constexpr stream_iterator operator-(stream_iterator it,
+                                             difference_type n) noexcept
+  {
+    return it -= n;
+  }
+
+  friend constexpr difference_type operator-(stream_iterator left,
+                                             stream_iterator right) noexcept
+  {
+    return static_cast<difference_type>(left.m_index - right.m_index);
+  }
+
+  friend constexpr bool operator==(stream_iterator left,
+                                   stream_iterator right) noexcept
+  {
+    return left.m_index == right.m_index;
+  }
+
+  friend constexpr std::strong_ordering operator<=>(
+      stream_iterator left, stream_iterator right) noexcept
+  {
+    return left.m_index <=> right.m_index;
+  }
+};
+
+/**
+ * An infinite random access view of the values that a
+ * counter_based_engine<trait_t, result_t> constructed from key and counter
+ * produces. Element i is computed with a single bijection, so a stream can
+ * be processed in chunks, e.g. by parallel algorithms over
+ * [begin() + first, begin() + last), and every chunk sees the same values
+ * that the engine would have drawn sequentially.
+ */
+template <class trait_t,
+          std::unsigned_integral result_t = typename trait_t::word_type>
+class counter_stream_view
+    : public std::ranges::view_interface<counter_stream_view<trait_t, result_t>>
+{
+  using engine_type = counter_based_engine<trait_t, result_t>;
+
+ public:
+  using key_type = typename trait_t::key_type;
+  using counter_type = typename trait_t::counter_type;
+  using internal_key_type = typename trait_t::internal_key_type;
+  using iterator = stream_iterator<counter_stream_view, result_t>;
+
+ private:
+  static constexpr size_t block_size =
+      typename engine_type::block_type{}.size();
+
+  internal_key_type m_key{};
+  // the counter of the block that holds element zero.
+  counter_type m_counter{};
+
+ public:
+  constexpr counter_stream_view() noexcept
+      : counter_stream_view(key_type{}, counter_type{})
+  {
+  }
+
+  constexpr counter_stream_view(key_type key, counter_type counter) noexcept
+      : m_key{trait_t::set_key(key)}, m_counter{counter}
+  {
+  }
+
+  explicit constexpr counter_stream_view(key_type key) noexcept
+      : counter_stream_view(key, counter_type{})
+  {
+  }
+
+  constexpr result_t value_at(uint64_t i) const noexcept
+  {
+    return engine_type::bijection(m_counter + i / block_size,
+                                  m_key)[i % block_size];
+  }
+
+  constexpr iterator begin() const noexcept { return iterator{*this, 0U}; }
+
+  constexpr std::unreachable_sentinel_t end() const noexcept
+  {
+    return std::unreachable_sentinel;
+  }
+
+  /**
+   * A view of the canonical values that next_canonical<T, bits, interval>
+   * would draw from the same engine.
+   */
+  template <std::floating_point T = double,
+            unsigned bits = std::numeric_limits<T>::digits,
+            canonical_interval interval = canonical_interval::closed_open>
+  constexpr auto canonical() const noexcept;
+
+  constexpr const internal_key_type& internal_key() const noexcept
+  {
+    return m_key;
+  }
+
+  constexpr const counter_type& counter() const noexcept { return m_counter; }
+};
+
+/**
+ * An infinite random access view whose i-th element is the value that the
+ * i-th call to next_canonical<T, bits, interval>() returns on the engine
+ * behind a counter_stream_view. Each element consumes as many consecutive
+ * values of the stream as next_canonical does.
+ */
+template <std::floating_point T, class trait_t,
+          std::unsigned_integral result_t = typename trait_t::word_type,
+          unsigned bits = std::numeric_limits<T>::digits,
+          canonical_interval interval = canonical_interval::closed_open>
+class canonical_view
+    : public std::ranges::view_interface<
+          canonical_view<T, trait_t, result_t, bits, interval>>
+{
+  counter_stream_view<trait_t, result_t> m_stream{};
+
+ public:
+  using iterator = stream_iterator<canonical_view, T>;
+
+  constexpr canonical_view() noexcept = default;
+
+  explicit constexpr canonical_view(
+      counter_stream_view<trait_t, result_t> stream) noexcept
+      : m_stream{stream}
+  {
+  }
+
+  constexpr T value_at(uint64_t i) const noexcept
+  {
+    return counter_based_engine<trait_t, result_t>::template canonical_at<
+        T, bits, interval>(m_stream.internal_key(), m_stream.counter(), i);
+  }
+
+  constexpr iterator begin() const noexcept { return iterator{*this, 0U}; }
+
+  constexpr std::unreachable_sentinel_t end() const noexcept
+  {
+    return std::unreachable_sentinel;
+  }
+};
+
+template <class trait_t, std::unsigned_integral result_t>
+template <std::floating_point T, unsigned bits, canonical_interval interval>
+constexpr auto counter_stream_view<trait_t, result_t>::canonical()
+    const noexcept
+{
+  return canonical_view<T, trait_t, result_t, bits, interval>{*this};
+}
+
+}  // namespace qtfy::random
+
+#endif
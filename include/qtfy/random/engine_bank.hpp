@@ -0,0 +1,95 @@
+#ifndef QTFY_RANDOM_ENGINE_BANK_HPP
+#define QTFY_RANDOM_ENGINE_BANK_HPP
+
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <vector>
+#include "key_derivation.hpp"
+
+namespace qtfy::random {
+
+/**
+ * The id of the pool worker that runs on the calling thread, as bound by
+ * bind_worker, or unbound_worker.
+ */
+inline constexpr size_t unbound_worker = std::numeric_limits<size_t>::max();
+
+namespace detail {
+inline thread_local size_t bound_worker = unbound_worker;
+}  // namespace detail
+
+/**
+ * Binds the calling thread to the worker id of a thread pool, so that
+ * engine_bank::local returns the engine of that worker. A pool calls this
+ * whenever one of its threads starts to run a worker, so worker n uses the
+ * same engine no matter which OS thread runs it.
+ */
+inline void bind_worker(size_t worker) noexcept
+{
+  detail::bound_worker = worker;
+}
+
+inline size_t bound_worker() noexcept { return detail::bound_worker; }
+
+/**
+ * One engine per worker, each in its own slot aligned to
+ * destructive_interference_size, so that workers drawing from neighbouring
+ * engines do not share cache lines. The engine of worker n is constructed
+ * from child n of split(key), so it only depends on the key and on n, and
+ * banks of different sizes agree on the engines they have in common.
+ */
+template <class engine_t>
+class engine_bank
+{
+ public:
+  using engine_type = engine_t;
+  using trait_type = typename engine_t::trait_type;
+  using key_type = typename trait_type::key_type;
+
+ private:
+  struct alignas(destructive_interference_size) slot
+  {
+    engine_t engine;
+  };
+
+  std::vector<slot> m_slots{};
+
+ public:
+  engine_bank(key_type key, size_t workers) : m_slots{}
+  {
+    std::vector<key_type> keys(workers);
+    split<trait_type>(key, keys);
+    m_slots.reserve(workers);
+    for (const auto& worker_key : keys)
+    {
+      m_slots.push_back(slot{engine_t{worker_key}});
+    }
+  }
+
+  engine_t& operator[](size_t worker) noexcept
+  {
+    return m_slots[worker].engine;
+  }
+
+  const engine_t& operator[](size_t worker) const noexcept
+  {
+    return m_slots[worker].engine;
+  }
+
+  size_t size() const noexcept { return m_slots.size(); }
+
+  /**
+   * The engine of the worker bound to the calling thread by bind_worker.
+   */
+  engine_t& local() noexcept
+  {
+    assert(bound_worker() < m_slots.size() &&
+           "the calling thread is not bound to a worker of this bank");
+    return m_slots[bound_worker()].engine;
+  }
+};
+
+}  // namespace qtfy::random
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef QTFY_RANDOM_KERNELS_HPP
+#define QTFY_RANDOM_KERNELS_HPP
+
+#include <span>
+
+namespace qtfy::random::kernels {
+
+/**
+ * Whether the batch bijection of trait_t is taken from the precompiled
+ * qtfy_random_kernels library. This is only the case for the traits of the
+ * eight engines in qtfy/random.hpp, and only for consumers that link the
+ * library, which defines QTFY_RANDOM_LINK_KERNELS for them and for itself.
+ */
+template <class trait_t>
+inline constexpr bool is_compiled = false;
+
+/**
+ * The batch bijection of trait_t as compiled into qtfy_random_kernels. It is
+ * always built at -O3 and, where the toolchain supports it, cloned for
+ * several instruction sets, so that it is fast regardless of the
+ * optimisation flags of the consumer.
+ */
+template <class trait_t>
+void bijection_batch(std::span<const typename trait_t::counter_type> counters,
+                     std::span<typename trait_t::counter_type> results,
+                     typename trait_t::internal_key_type key) noexcept;
+
+}  // namespace qtfy::random::kernels
+
+#endif
@@ -0,0 +1,140 @@
+#ifndef QTFY_RANDOM_KEY_DERIVATION_HPP
+#define QTFY_RANDOM_KEY_DERIVATION_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <span>
+#include <vector>
+#include "counter.hpp"
+#include "counter_based_engine.hpp"
+
+namespace qtfy::random {
+
+/**
+ * The child key derived from a block of the bijection, i.e. its lowest
+ * words.
+ */
+template <class trait_t>
+constexpr auto derived_key(const typename trait_t::counter_type& block) noexcept
+{
+  using key_type = typename trait_t::key_type;
+  using counter_type = typename trait_t::counter_type;
+  static_assert(key_type{}.size() <= counter_type{}.size());
+  key_type key{};
+  std::copy_n(block.begin(), key.size(), key.begin());
+  return key;
+}
+
+namespace detail {
+
+/**
+ * Whether data leaves the highest bit of the counter clear. The children of
+ * split set that bit and those of fold_in do not, so the two derivations
+ * never give the same key. Only counters of 64 bits, i.e. those of the 2x32
+ * traits, can hold a uint64_t that reaches it.
+ */
+template <class trait_t>
+constexpr bool below_domain_bit(uint64_t data) noexcept
+{
+  using word_type = typename trait_t::word_type;
+  constexpr size_t counter_bits = typename trait_t::counter_type{}.size() *
+                                  std::numeric_limits<word_type>::digits;
+  return counter_bits > 64U || data >> 63U == 0U;
+}
+
+}  // namespace detail
+
+/**
+ * Derives a child key from parent and data in the style of fold_in in JAX.
+ * The child is made of the lowest words of bijection(counter{data},
+ * set_key(parent)), so a key tree only depends on the path from its root
+ * and not on the order in which keys are derived. For the 2x32 traits data
+ * must be below pow(2, 63).
+ */
+template <class trait_t>
+constexpr auto fold_in(typename trait_t::key_type parent,
+                       uint64_t data) noexcept
+{
+  using counter_type = typename trait_t::counter_type;
+  assert(detail::below_domain_bit<trait_t>(data) &&
+         "data reaches the domain bit of split");
+  return derived_key<trait_t>(
+      trait_t::bijection(counter_type{} + data, trait_t::set_key(parent)));
+}
+
+/**
+ * Writes fold_in(parent, data[i]) to children[i] for every element of data.
+ * The key of parent is set once, and the bijections of up to 64 children at
+ * a time are computed in a single batched call.
+ */
+template <class trait_t>
+constexpr void fold_in(typename trait_t::key_type parent,
+                       std::span<const uint64_t> data,
+                       std::span<typename trait_t::key_type> children) noexcept
+{
+  using counter_type = typename trait_t::counter_type;
+  constexpr size_t batch_size = 64U;
+  const auto key = trait_t::set_key(parent);
+  std::array<counter_type, batch_size> counters{};
+  std::array<counter_type, batch_size> blocks{};
+  for (size_t first{}; first < data.size(); first += batch_size)
+  {
+    const size_t count = std::min(data.size() - first, batch_size);
+    for (size_t i{}; i < count; ++i)
+    {
+      assert(detail::below_domain_bit<trait_t>(data[first + i]) &&
+             "data reaches the domain bit of split");
+      counters[i] = counter_type{} + data[first + i];
+    }
+    detail::bijection_batch<trait_t>({counters.data(), count},
+                                     {blocks.data(), count}, key);
+    for (size_t i{}; i < count; ++i)
+    {
+      children[first + i] = derived_key<trait_t>(blocks[i]);
+    }
+  }
+}
+
+/**
+ * Writes child first + i of parent to children[i] for every child, in the
+ * style of split in JAX. Child i is made of the lowest words of
+ * bijection(counter{i} with its highest bit set, set_key(parent)), so it
+ * does not depend on the number of children and can also be derived lazily
+ * by passing a single child and first = i. The highest bit keeps the
+ * children of split apart from those of fold_in, so for the 2x32 traits
+ * first + children.size() must not exceed pow(2, 63).
+ */
+template <class trait_t>
+constexpr void split(typename trait_t::key_type parent,
+                     std::span<typename trait_t::key_type> children,
+                     uint64_t first = 0U) noexcept
+{
+  using counter_type = typename trait_t::counter_type;
+  using word_type = typename trait_t::word_type;
+  assert(children.empty() ||
+         (detail::below_domain_bit<trait_t>(first) &&
+          detail::below_domain_bit<trait_t>(first + (children.size() - 1U)) &&
+          "the children reach the domain bit of split"));
+  counter_type ctr = counter_type{} + first;
+  ctr.back() |= word_type{1U} << (std::numeric_limits<word_type>::digits - 1);
+  auto child = children.begin();
+  detail::for_each_block<trait_t, 64U>(
+      ctr, children.size(), trait_t::set_key(parent),
+      [&child](const counter_type& block) {
+        *child++ = derived_key<trait_t>(block);
+      });
+}
+
+template <class trait_t>
+std::vector<typename trait_t::key_type> split(
+    typename trait_t::key_type parent, size_t n)
+{
+  std::vector<typename trait_t::key_type> children(n);
+  split<trait_t>(parent, children);
+  return children;
+}
+
+}  // namespace qtfy::random
+
+#endif
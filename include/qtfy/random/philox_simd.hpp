@@ -0,0 +1,568 @@
+#ifndef QTFY_RANDOM_PHILOX_SIMD_HPP
+#define QTFY_RANDOM_PHILOX_SIMD_HPP
+
+#include "counter.hpp"
+#include "simd.hpp"
+
+namespace qtfy::random {
+
+template <class word_t, size_t words, unsigned rounds,
+          std::array<word_t, words / 2U> bumps,
+          std::array<uint64_t, words / 2U> multipliers>
+class philox_trait;
+
+}  // namespace qtfy::random
+
+namespace qtfy::random::simd {
+
+template <class trait_t>
+struct philox_kernel;
+
+/**
+ * Multi lane philox kernels. Each kernel applies the bijection of the trait
+ * to as many whole groups of counters as fit in count and returns the number
+ * of counters it processed, leaving the remainder to the scalar bijection.
+ * The counters are transposed so that every vector register holds the same
+ * word of several counters, and each round is computed with widening
+ * 32 x 32 -> 64 bit vector multiplies. For 64 bit words the 128 bit product
+ * is assembled from four such partial products, mirroring utilities::big_mul.
+ * The round keys are broadcast from the schedule computed by set_key.
+ * The portable kernel runs the same rounds on simd::pack, so it vectorises
+ * for whatever instruction set the caller is compiled for.
+ */
+template <class word_t, size_t words, unsigned rounds,
+          std::array<word_t, words / 2U> bumps,
+          std::array<uint64_t, words / 2U> multipliers>
+struct philox_kernel<philox_trait<word_t, words, rounds, bumps, multipliers>>
+{
+  using counter_type = counter<word_t, words>;
+  using key_type = counter<word_t, words / 2U>;
+  using internal_key_type = std::array<key_type, rounds>;
+
+#if QTFY_RANDOM_X86_SIMD
+ private:
+  template <uint64_t multiplier>
+  QTFY_TARGET_AVX2 static void mulhilo_avx2(__m256i x, __m256i& hi,
+                                            __m256i& lo) noexcept
+  {
+    if constexpr (std::is_same_v<word_t, uint32_t>)
+    {
+      // _mm256_mul_epu32 only multiplies the even 32 bit lanes, so the odd
+      // lanes are shifted into place and multiplied separately.
+      const __m256i m = _mm256_set1_epi32(static_cast<int>(multiplier));
+      const __m256i even = _mm256_mul_epu32(x, m);
+      const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(x, 32), m);
+      lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+      hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+    }
+    else
+    {
+      const __m256i mask = _mm256_set1_epi64x(0xFFFFFFFF);
+      const __m256i m_lo =
+          _mm256_set1_epi64x(static_cast<long long>(multiplier & 0xFFFFFFFFU));
+      const __m256i m_hi =
+          _mm256_set1_epi64x(static_cast<long long>(multiplier >> 32U));
+      const __m256i x_hi = _mm256_srli_epi64(x, 32);
+      const __m256i ll = _mm256_mul_epu32(x, m_lo);
+      const __m256i t = _mm256_add_epi64(_mm256_mul_epu32(x, m_hi),
+                                         _mm256_srli_epi64(ll, 32));
+      const __m256i tl = _mm256_add_epi64(_mm256_mul_epu32(x_hi, m_lo),
+                                          _mm256_and_si256(t, mask));
+      hi = _mm256_add_epi64(
+          _mm256_add_epi64(_mm256_mul_epu32(x_hi, m_hi),
+                           _mm256_srli_epi64(t, 32)),
+          _mm256_srli_epi64(tl, 32));
+      lo = _mm256_or_si256(_mm256_slli_epi64(tl, 32),
+                           _mm256_and_si256(ll, mask));
+    }
+  }
+
+  QTFY_TARGET_AVX2 static void round_avx2(
+      __m256i (&ctr)[words], const __m256i (&key)[words / 2U]) noexcept
+  {
+    if constexpr (words == 2U)
+    {
+      __m256i hi;
+      __m256i lo;
+      mulhilo_avx2<multipliers[0U]>(ctr[0U], hi, lo);
+      ctr[0U] = _mm256_xor_si256(_mm256_xor_si256(hi, key[0U]), ctr[1U]);
+      ctr[1U] = lo;
+    }
+    if constexpr (words == 4U)
+    {
+      __m256i hi0;
+      __m256i lo0;
+      __m256i hi1;
+      __m256i lo1;
+      mulhilo_avx2<multipliers[0U]>(ctr[0U], hi0, lo0);
+      mulhilo_avx2<multipliers[1U]>(ctr[2U], hi1, lo1);
+      ctr[0U] = _mm256_xor_si256(_mm256_xor_si256(hi1, ctr[1U]), key[0U]);
+      ctr[1U] = lo1;
+      ctr[2U] = _mm256_xor_si256(_mm256_xor_si256(hi0, ctr[3U]), key[1U]);
+      ctr[3U] = lo0;
+    }
+  }
+
+  // the zero masked forms of the multiplies and shifts, since the unmasked
+  // ones pass an undefined vector through, which GCC reports as
+  // uninitialized once they are inlined.
+  template <uint64_t multiplier>
+  QTFY_TARGET_AVX512 static void mulhilo_avx512(__m512i x, __m512i& hi,
+                                                __m512i& lo) noexcept
+  {
+    if constexpr (std::is_same_v<word_t, uint32_t>)
+    {
+      const __m512i m = _mm512_set1_epi32(static_cast<int>(multiplier));
+      const __m512i even = _mm512_maskz_mul_epu32(0xFF, x, m);
+      const __m512i odd =
+          _mm512_maskz_mul_epu32(0xFF, _mm512_maskz_srli_epi64(0xFF, x, 32), m);
+      lo = _mm512_mask_blend_epi32(0xAAAA, even,
+                                   _mm512_maskz_slli_epi64(0xFF, odd, 32));
+      hi = _mm512_mask_blend_epi32(
+          0xAAAA, _mm512_maskz_srli_epi64(0xFF, even, 32), odd);
+    }
+    else
+    {
+      const __m512i mask = _mm512_set1_epi64(0xFFFFFFFF);
+      const __m512i m_lo =
+          _mm512_set1_epi64(static_cast<long long>(multiplier & 0xFFFFFFFFU));
+      const __m512i m_hi =
+          _mm512_set1_epi64(static_cast<long long>(multiplier >> 32U));
+      const __m512i x_hi = _mm512_maskz_srli_epi64(0xFF, x, 32);
+      const __m512i ll = _mm512_maskz_mul_epu32(0xFF, x, m_lo);
+      const __m512i t =
+          _mm512_add_epi64(_mm512_maskz_mul_epu32(0xFF, x, m_hi),
+                           _mm512_maskz_srli_epi64(0xFF, ll, 32));
+      const __m512i tl =
+          _mm512_add_epi64(_mm512_maskz_mul_epu32(0xFF, x_hi, m_lo),
+                           _mm512_and_si512(t, mask));
+      hi = _mm512_add_epi64(
+          _mm512_add_epi64(_mm512_maskz_mul_epu32(0xFF, x_hi, m_hi),
+                           _mm512_maskz_srli_epi64(0xFF, t, 32)),
+          _mm512_maskz_srli_epi64(0xFF, tl, 32));
+      lo = _mm512_or_si512(_mm512_maskz_slli_epi64(0xFF, tl, 32),
+                           _mm512_and_si512(ll, mask));
+    }
+  }
+
+  QTFY_TARGET_AVX512 static void round_avx512(
+      __m512i (&ctr)[words], const __m512i (&key)[words / 2U]) noexcept
+  {
+    if constexpr (words == 2U)
+    {
+      __m512i hi;
+      __m512i lo;
+      mulhilo_avx512<multipliers[0U]>(ctr[0U], hi, lo);
+      ctr[0U] = _mm512_xor_si512(_mm512_xor_si512(hi, key[0U]), ctr[1U]);
+      ctr[1U] = lo;
+    }
+    if constexpr (words == 4U)
+    {
+      __m512i hi0;
+      __m512i lo0;
+      __m512i hi1;
+      __m512i lo1;
+      mulhilo_avx512<multipliers[0U]>(ctr[0U], hi0, lo0);
+      mulhilo_avx512<multipliers[1U]>(ctr[2U], hi1, lo1);
+      ctr[0U] = _mm512_xor_si512(_mm512_xor_si512(hi1, ctr[1U]), key[0U]);
+      ctr[1U] = lo1;
+      ctr[2U] = _mm512_xor_si512(_mm512_xor_si512(hi0, ctr[3U]), key[1U]);
+      ctr[3U] = lo0;
+    }
+  }
+
+ public:
+  QTFY_TARGET_AVX2 static size_t avx2(const counter_type* counters,
+                                      counter_type* results, size_t count,
+                                      const internal_key_type& key) noexcept
+  {
+    constexpr size_t lanes = sizeof(__m256i) / sizeof(word_t);
+    const size_t full = count - count % lanes;
+    for (size_t i{}; i != full; i += lanes)
+    {
+      alignas(__m256i) word_t lanes_data[words][lanes];
+      to_lanes(counters + i, lanes_data);
+
+      __m256i ctr[words];
+      __m256i round_key[words / 2U];
+      for (size_t w{}; w < words; ++w)
+      {
+        ctr[w] = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(lanes_data[w]));
+      }
+      for (unsigned r{}; r < rounds; ++r)
+      {
+        for (size_t w{}; w < words / 2U; ++w)
+        {
+          round_key[w] = broadcast_avx2<word_t>(key[r][w]);
+        }
+        round_avx2(ctr, round_key);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_data[w]), ctr[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+
+  QTFY_TARGET_AVX512 static size_t avx512(const counter_type* counters,
+                                          counter_type* results, size_t count,
+                                          const internal_key_type& key) noexcept
+  {
+    constexpr size_t lanes = sizeof(__m512i) / sizeof(word_t);
+    const size_t full = count - count % lanes;
+    for (size_t i{}; i != full; i += lanes)
+    {
+      alignas(__m512i) word_t lanes_data[words][lanes];
+      to_lanes(counters + i, lanes_data);
+
+      __m512i ctr[words];
+      __m512i round_key[words / 2U];
+      for (size_t w{}; w < words; ++w)
+      {
+        ctr[w] = _mm512_load_si512(lanes_data[w]);
+      }
+      for (unsigned r{}; r < rounds; ++r)
+      {
+        for (size_t w{}; w < words / 2U; ++w)
+        {
+          round_key[w] = broadcast_avx512<word_t>(key[r][w]);
+        }
+        round_avx512(ctr, round_key);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        _mm512_store_si512(lanes_data[w], ctr[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+
+  /**
+   * Applies the bijection of the key keys[i] to ctr for lanes keys at a
+   * time. The keys are transposed like the counters of avx2, ctr is
+   * broadcast, and the round keys are bumped in the vector registers instead
+   * of being loaded from a schedule.
+   */
+  QTFY_TARGET_AVX2 static size_t avx2_keys(counter_type ctr,
+                                           const key_type* keys,
+                                           counter_type* results,
+                                           size_t count) noexcept
+  {
+    constexpr size_t lanes = sizeof(__m256i) / sizeof(word_t);
+    const size_t full = count - count % lanes;
+
+    __m256i counter_words[words];
+    __m256i bump[words / 2U];
+    for (size_t w{}; w < words; ++w)
+    {
+      counter_words[w] = broadcast_avx2<word_t>(ctr[w]);
+    }
+    for (size_t w{}; w < words / 2U; ++w)
+    {
+      bump[w] = broadcast_avx2<word_t>(bumps[w]);
+    }
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      alignas(__m256i) word_t key_lanes[words / 2U][lanes];
+      alignas(__m256i) word_t lanes_data[words][lanes];
+      to_lanes(keys + i, key_lanes);
+
+      __m256i block[words];
+      __m256i round_key[words / 2U];
+      for (size_t w{}; w < words; ++w)
+      {
+        block[w] = counter_words[w];
+      }
+      for (size_t w{}; w < words / 2U; ++w)
+      {
+        round_key[w] = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(key_lanes[w]));
+      }
+      for (unsigned r{}; r < rounds; ++r)
+      {
+        round_avx2(block, round_key);
+        for (size_t w{}; w < words / 2U; ++w)
+        {
+          round_key[w] = add_avx2<word_t>(round_key[w], bump[w]);
+        }
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_data[w]),
+                           block[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+
+  QTFY_TARGET_AVX512 static size_t avx512_keys(counter_type ctr,
+                                               const key_type* keys,
+                                               counter_type* results,
+                                               size_t count) noexcept
+  {
+    constexpr size_t lanes = sizeof(__m512i) / sizeof(word_t);
+    const size_t full = count - count % lanes;
+
+    __m512i counter_words[words];
+    __m512i bump[words / 2U];
+    for (size_t w{}; w < words; ++w)
+    {
+      counter_words[w] = broadcast_avx512<word_t>(ctr[w]);
+    }
+    for (size_t w{}; w < words / 2U; ++w)
+    {
+      bump[w] = broadcast_avx512<word_t>(bumps[w]);
+    }
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      alignas(__m512i) word_t key_lanes[words / 2U][lanes];
+      alignas(__m512i) word_t lanes_data[words][lanes];
+      to_lanes(keys + i, key_lanes);
+
+      __m512i block[words];
+      __m512i round_key[words / 2U];
+      for (size_t w{}; w < words; ++w)
+      {
+        block[w] = counter_words[w];
+      }
+      for (size_t w{}; w < words / 2U; ++w)
+      {
+        round_key[w] = _mm512_load_si512(key_lanes[w]);
+      }
+      for (unsigned r{}; r < rounds; ++r)
+      {
+        round_avx512(block, round_key);
+        for (size_t w{}; w < words / 2U; ++w)
+        {
+          round_key[w] = add_avx512<word_t>(round_key[w], bump[w]);
+        }
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        _mm512_store_si512(lanes_data[w], block[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+#endif
+
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+ private:
+  template <size_t lanes>
+  static void round_portable(
+      pack<word_t, lanes> (&ctr)[words],
+      const pack<word_t, lanes> (&key)[words / 2U]) noexcept
+  {
+    if constexpr (words == 2U)
+    {
+      pack<word_t, lanes> hi;
+      pack<word_t, lanes> lo;
+      mulhilo<multipliers[0U]>(ctr[0U], hi, lo);
+      ctr[0U] = hi ^ key[0U] ^ ctr[1U];
+      ctr[1U] = lo;
+    }
+    if constexpr (words == 4U)
+    {
+      pack<word_t, lanes> hi0;
+      pack<word_t, lanes> lo0;
+      pack<word_t, lanes> hi1;
+      pack<word_t, lanes> lo1;
+      mulhilo<multipliers[0U]>(ctr[0U], hi0, lo0);
+      mulhilo<multipliers[1U]>(ctr[2U], hi1, lo1);
+      ctr[0U] = hi1 ^ ctr[1U] ^ key[0U];
+      ctr[1U] = lo1;
+      ctr[2U] = hi0 ^ ctr[3U] ^ key[1U];
+      ctr[3U] = lo0;
+    }
+  }
+
+ public:
+  template <size_t width = portable_width>
+  static size_t portable(const counter_type* counters, counter_type* results,
+                         size_t count, const internal_key_type& key) noexcept
+  {
+    constexpr size_t lanes = width / sizeof(word_t);
+    using pack_type = pack<word_t, lanes>;
+    const size_t full = count - count % lanes;
+    for (size_t i{}; i != full; i += lanes)
+    {
+      word_t lanes_data[words][lanes];
+      to_lanes(counters + i, lanes_data);
+
+      pack_type ctr[words];
+      pack_type round_key[words / 2U];
+      for (size_t w{}; w < words; ++w)
+      {
+        ctr[w] = pack_type::load(lanes_data[w]);
+      }
+      for (unsigned r{}; r < rounds; ++r)
+      {
+        for (size_t w{}; w < words / 2U; ++w)
+        {
+          round_key[w] = pack_type::broadcast(key[r][w]);
+        }
+        round_portable(ctr, round_key);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        ctr[w].store(lanes_data[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+
+  template <size_t width = portable_width>
+  static size_t portable_keys(counter_type ctr, const key_type* keys,
+                              counter_type* results, size_t count) noexcept
+  {
+    constexpr size_t lanes = width / sizeof(word_t);
+    using pack_type = pack<word_t, lanes>;
+    const size_t full = count - count % lanes;
+
+    pack_type counter_words[words];
+    pack_type bump[words / 2U];
+    for (size_t w{}; w < words; ++w)
+    {
+      counter_words[w] = pack_type::broadcast(ctr[w]);
+    }
+    for (size_t w{}; w < words / 2U; ++w)
+    {
+      bump[w] = pack_type::broadcast(bumps[w]);
+    }
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      word_t key_lanes[words / 2U][lanes];
+      word_t lanes_data[words][lanes];
+      to_lanes(keys + i, key_lanes);
+
+      pack_type block[words];
+      pack_type round_key[words / 2U];
+      for (size_t w{}; w < words; ++w)
+      {
+        block[w] = counter_words[w];
+      }
+      for (size_t w{}; w < words / 2U; ++w)
+      {
+        round_key[w] = pack_type::load(key_lanes[w]);
+      }
+      for (unsigned r{}; r < rounds; ++r)
+      {
+        round_portable(block, round_key);
+        for (size_t w{}; w < words / 2U; ++w)
+        {
+          round_key[w] = round_key[w] + bump[w];
+        }
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        block[w].store(lanes_data[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+#endif
+
+  using kernel_type = size_t (*)(const counter_type*, counter_type*, size_t,
+                                 const internal_key_type&) noexcept;
+
+  static size_t scalar(const counter_type*, counter_type*, size_t,
+                       const internal_key_type&) noexcept
+  {
+    return 0U;
+  }
+
+  /**
+   * The kernel for active_instruction_set().
+   */
+  static kernel_type select() noexcept
+  {
+    switch (active_instruction_set())
+    {
+#if QTFY_RANDOM_X86_SIMD
+      case instruction_set::avx512:
+        return avx512;
+      case instruction_set::avx2:
+        return avx2;
+#endif
+#if QTFY_RANDOM_VECTOR_EXTENSIONS && !QTFY_RANDOM_X86_SIMD
+      // sse2 lacks a 64 bit lane multiply, so below avx2 the scalar mul is
+      // faster than the portable kernel on x86 and is used instead.
+      case instruction_set::portable:
+        return portable;
+#endif
+      default:
+        return scalar;
+    }
+  }
+
+  /**
+   * Runs the kernel for active_instruction_set() and returns the number of
+   * counters that were processed. The kernel is selected on the first call.
+   */
+  static size_t run(const counter_type* counters, counter_type* results,
+                    size_t count, const internal_key_type& key) noexcept
+  {
+    static const kernel_type kernel = select();
+    return kernel(counters, results, count, key);
+  }
+
+  using keys_kernel_type = size_t (*)(counter_type, const key_type*,
+                                      counter_type*, size_t) noexcept;
+
+  static size_t scalar_keys(counter_type, const key_type*, counter_type*,
+                            size_t) noexcept
+  {
+    return 0U;
+  }
+
+  static keys_kernel_type select_keys() noexcept
+  {
+    switch (active_instruction_set())
+    {
+#if QTFY_RANDOM_X86_SIMD
+      case instruction_set::avx512:
+        return avx512_keys;
+      case instruction_set::avx2:
+        return avx2_keys;
+#endif
+#if QTFY_RANDOM_VECTOR_EXTENSIONS && !QTFY_RANDOM_X86_SIMD
+      case instruction_set::portable:
+        return portable_keys;
+#endif
+      default:
+        return scalar_keys;
+    }
+  }
+
+  /**
+   * Runs the kernel over keys for active_instruction_set() and returns the
+   * number of keys that were processed.
+   */
+  static size_t run_keys(counter_type ctr, const key_type* keys,
+                         counter_type* results, size_t count) noexcept
+  {
+    static const keys_kernel_type kernel = select_keys();
+    return kernel(ctr, keys, results, count);
+  }
+};
+
+}  // namespace qtfy::random::simd
+
+#endif
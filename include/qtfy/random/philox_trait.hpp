@@ -1,7 +1,12 @@
 #ifndef QTFY_RANDOM_PHILOX_TRAIT_HPP
 #define QTFY_RANDOM_PHILOX_TRAIT_HPP
 
+#include <algorithm>
+#include <span>
+#include <utility>
 #include "counter.hpp"
+#include "kernels.hpp"
+#include "philox_simd.hpp"
 
 namespace qtfy::random {
 
@@ -18,11 +23,17 @@ class philox_trait
 
   using counter_type = counter<word_t, words>;
   using key_type = counter<word_t, words / 2>;
-  using internal_key_type = key_type;
+  // the round keys of every round, as computed by set_key. This trades
+  // state for speed: the internal key is rounds times the size of the key,
+  // e.g. 80 instead of 8 bytes for philox4x32_trait<10>, and every engine
+  // that stores an internal key, such as counter_based_engine and the slots
+  // of engine_bank, grows with it. compact_counter_engine keeps the key
+  // itself, as it sets the key on every draw anyway.
+  using internal_key_type = std::array<key_type, rounds>;
   using word_type = word_t;
 
  private:
-  static constexpr internal_key_type bump_key(internal_key_type key) noexcept
+  static constexpr key_type bump_key(key_type key) noexcept
   {
     for (size_t i{}; i < bumps.size(); ++i)
     {
@@ -32,8 +43,7 @@ class philox_trait
     return key;
   }
 
-  static constexpr counter_type round(counter_type ctr,
-                                      internal_key_type key) noexcept
+  static constexpr counter_type round(counter_type ctr, key_type key) noexcept
   {
     using namespace qtfy::random::utilities;
 
@@ -82,28 +92,29 @@ class philox_trait
   }
 
   template <unsigned r>
-  static constexpr auto round_applier(key_type key, auto ctr) noexcept
+  static constexpr auto round_applier(const internal_key_type& keys,
+                                      auto ctr) noexcept
   {
     using namespace qtfy::random::utilities;
     if constexpr (words == 2U)
     {
       const auto product = big_mul<multipliers[0U]>(ctr[0U]);
-      ctr[0U] = product.hi ^ key[0U] ^ ctr[1U];
+      ctr[0U] = product.hi ^ keys[r][0U] ^ ctr[1U];
       ctr[1U] = product.lo;
     }
     if constexpr (words == 4U)
     {
       const auto product0 = big_mul<multipliers[0U]>(ctr[0U]);
       const auto product1 = big_mul<multipliers[1U]>(ctr[2U]);
-      ctr[0U] = product1.hi ^ ctr[1U] ^ key[0U];
+      ctr[0U] = product1.hi ^ ctr[1U] ^ keys[r][0U];
       ctr[1U] = product1.lo;
-      ctr[2U] = product0.hi ^ ctr[3U] ^ key[1U];
+      ctr[2U] = product0.hi ^ ctr[3U] ^ keys[r][1U];
       ctr[3U] = product0.lo;
     }
 
     if constexpr (r + 1U < rounds)
     {
-      return round_applier<r + 1>(bump_key(key), ctr);
+      return round_applier<r + 1>(keys, ctr);
     }
     else
     {
@@ -112,9 +123,20 @@ class philox_trait
   }
 
  public:
+  /**
+   * Computes the key of every round up front, in the same way that the
+   * extended key of threefry is computed once, so that the bijection only
+   * loads round keys instead of bumping the key inside the round chain.
+   */
   static constexpr internal_key_type set_key(key_type key) noexcept
   {
-    return key;
+    internal_key_type result{};
+    for (auto& round_key : result)
+    {
+      round_key = key;
+      key = bump_key(key);
+    }
+    return result;
   }
 
   template <key_type key>
@@ -143,6 +165,111 @@ class philox_trait
     }
   }
 
+  /**
+   * The number of counters that bijection_batch interleaves when it has no
+   * simd kernel for them. Four word counters already carry two independent
+   * multiplies per round, so fewer of them are needed to fill the core.
+   */
+  static constexpr size_t interleave = words == 4U ? 2U : 4U;
+
+  /**
+   * Applies the bijection to n independent counters at once. The rounds of
+   * all counters are interleaved, so that the multiplies of different
+   * counters overlap instead of each waiting on the previous round.
+   */
+  template <size_t n>
+  static constexpr std::array<counter_type, n> bijection_n(
+      std::array<counter_type, n> ctrs, internal_key_type key) noexcept
+  {
+    for (unsigned r{}; r < rounds; ++r)
+    {
+      [&]<size_t... i>(std::index_sequence<i...>)
+      {
+        ((ctrs[i] = round(ctrs[i], key[r])), ...);
+      }
+      (std::make_index_sequence<n>{});
+    }
+    return ctrs;
+  }
+
+  /**
+   * Applies the bijection to every counter in counters and writes the
+   * results to the corresponding position in results, which must be at
+   * least as large as counters. Outside of constant evaluation whole groups
+   * of counters are processed by the widest simd kernel available, and the
+   * rest interleave counters at a time through bijection_n.
+   */
+  static constexpr void bijection_batch(std::span<const counter_type> counters,
+                                        std::span<counter_type> results,
+                                        internal_key_type key) noexcept
+  {
+#if QTFY_RANDOM_LINK_KERNELS
+    if constexpr (kernels::is_compiled<philox_trait>)
+    {
+      if (!std::is_constant_evaluated())
+      {
+        kernels::bijection_batch<philox_trait>(counters, results, key);
+        return;
+      }
+    }
+#endif
+    bijection_batch_inline(counters, results, key);
+  }
+
+  /**
+   * bijection_batch as implemented in this header, which never forwards to
+   * qtfy_random_kernels. The library builds its kernels from it.
+   */
+  static constexpr void bijection_batch_inline(
+      std::span<const counter_type> counters, std::span<counter_type> results,
+      internal_key_type key) noexcept
+  {
+    size_t done{};
+    if (!std::is_constant_evaluated())
+    {
+      done = simd::philox_kernel<philox_trait>::run(
+          counters.data(), results.data(), counters.size(), key);
+    }
+    size_t i{done};
+    for (; counters.size() - i >= interleave; i += interleave)
+    {
+      std::array<counter_type, interleave> group{};
+      std::copy_n(counters.begin() + static_cast<std::ptrdiff_t>(i),
+                  interleave, group.begin());
+      group = bijection_n(group, key);
+      std::copy(group.begin(), group.end(),
+                results.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    for (; i < counters.size(); ++i)
+    {
+      results[i] = bijection(counters[i], key);
+    }
+  }
+
+  /**
+   * Applies the bijection of every key in keys to the single counter ctr
+   * and writes the results to out, which must be at least as large as keys.
+   * This is the transpose of bijection_batch: outside of constant evaluation
+   * whole groups of keys are processed by the widest simd kernel available,
+   * which expands the keys in its vector registers, and the rest by the
+   * scalar bijection.
+   */
+  static constexpr void bijection_keys(counter_type ctr,
+                                       std::span<const key_type> keys,
+                                       std::span<counter_type> out) noexcept
+  {
+    size_t done{};
+    if (!std::is_constant_evaluated())
+    {
+      done = simd::philox_kernel<philox_trait>::run_keys(
+          ctr, keys.data(), out.data(), keys.size());
+    }
+    for (size_t i{done}; i < keys.size(); ++i)
+    {
+      out[i] = bijection(ctr, set_key(keys[i]));
+    }
+  }
+
   static constexpr auto make_bijection(key_type key) noexcept
   {
     return [extended_key = set_key(key)](counter_type ctr) noexcept {
@@ -184,6 +311,17 @@ using philox4x64_trait =
     philox4_trait<uint64_t, rounds, 0x9E3779B97F4A7C15, 0xBB67AE8584CAA73B,
                   0xD2E7470EE14C6C93, 0xCA5A826395121157>;
 
+#if QTFY_RANDOM_LINK_KERNELS
+template <>
+inline constexpr bool kernels::is_compiled<philox2x32_trait<10>> = true;
+template <>
+inline constexpr bool kernels::is_compiled<philox2x64_trait<10>> = true;
+template <>
+inline constexpr bool kernels::is_compiled<philox4x32_trait<10>> = true;
+template <>
+inline constexpr bool kernels::is_compiled<philox4x64_trait<10>> = true;
+#endif
+
 template <std::unsigned_integral word_t, size_t words, unsigned rounds>
 requires(std::is_same_v<uint64_t, word_t>&& words ==
          2) constexpr auto philox_factory(counter<uint64_t, 1> key) noexcept
@@ -0,0 +1,236 @@
+#ifndef QTFY_RANDOM_SHARED_COUNTER_ENGINE_HPP
+#define QTFY_RANDOM_SHARED_COUNTER_ENGINE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <span>
+#include <vector>
+#include "counter_based_engine.hpp"
+
+namespace qtfy::random {
+
+/**
+ * One stream of counter_based_engine<trait_t, result_t> shared by many
+ * threads without a lock. Threads reserve consecutive blocks with a single
+ * fetch_add on an atomic block count and compute the values of their blocks
+ * on their own, typically through a consumer that buffers one reservation at
+ * a time.
+ *
+ * The atomic only holds the number of blocks reserved so far, which is added
+ * to the full width counter of the first block. Counters wider than 64 bits,
+ * for which std::atomic would not be lock free, therefore need no lock
+ * either, and the stream can start anywhere in the counter space, e.g. at a
+ * substream.
+ *
+ * Block b of the stream holds the values that an engine constructed from
+ * the same key and counter draws at positions [b * block_size,
+ * (b + 1) * block_size), so every reservation can be audited against the
+ * sequential engine.
+ *
+ * The block count is aligned to destructive_interference_size, so that the
+ * fetch_add of one thread does not evict the key and counter that the other
+ * threads read on every fill.
+ */
+template <class trait_t,
+          std::unsigned_integral result_t = typename trait_t::word_type>
+class shared_counter_engine
+{
+ public:
+  using key_type = typename trait_t::key_type;
+  using counter_type = typename trait_t::counter_type;
+  using internal_key_type = typename trait_t::internal_key_type;
+  using engine_type = counter_based_engine<trait_t, result_t>;
+  using block_type = typename engine_type::block_type;
+
+  static constexpr size_t block_size = block_type{}.size();
+
+  /**
+   * count consecutive blocks of the stream, the first of which is block
+   * first_block and has the counter first_counter.
+   */
+  struct block_range
+  {
+    uint64_t first_block{};
+    uint64_t count{};
+    counter_type first_counter{};
+
+    friend constexpr bool operator==(const block_range&,
+                                     const block_range&) noexcept = default;
+  };
+
+  class consumer;
+
+ private:
+  static constexpr size_t batch_size = 16U;
+
+  internal_key_type m_key{};
+  // the counter of block zero.
+  counter_type m_counter{};
+  alignas(destructive_interference_size) std::atomic<uint64_t> m_reserved{};
+
+ public:
+  explicit shared_counter_engine(key_type key,
+                                 counter_type counter = {}) noexcept
+      : m_key{trait_t::set_key(key)}, m_counter{counter}
+  {
+  }
+
+  shared_counter_engine(const shared_counter_engine&) = delete;
+  shared_counter_engine& operator=(const shared_counter_engine&) = delete;
+
+  /**
+   * Reserves the next blocks blocks of the stream for the calling thread.
+   * Concurrent calls receive disjoint ranges, and together the ranges cover
+   * the stream from block zero without gaps.
+   */
+  block_range reserve(uint64_t blocks) noexcept
+  {
+    const uint64_t first =
+        m_reserved.fetch_add(blocks, std::memory_order_relaxed);
+    assert(first <= std::numeric_limits<uint64_t>::max() - blocks &&
+           "the block count of the shared stream has overflowed");
+    return {first, blocks, m_counter + first};
+  }
+
+  // the number of blocks reserved so far.
+  uint64_t reserved() const noexcept
+  {
+    return m_reserved.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * Writes the values of the blocks in range to values, which must hold at
+   * least range.count * block_size elements. The bijections of up to
+   * batch_size blocks at a time are computed in a single batched call.
+   */
+  void fill(const block_range& range, std::span<result_t> values) const noexcept
+  {
+    assert(values.size() / block_size >= range.count);
+    auto out = values.begin();
+    detail::for_each_block<trait_t, batch_size>(
+        range.first_counter, range.count, m_key,
+        [&out](const counter_type& block) {
+          const block_type words = reinterpret<result_t>(block);
+          out = std::copy(words.begin(), words.end(), out);
+        });
+  }
+
+  /**
+   * A consumer for the calling thread that reserves
+   * blocks_per_reservation blocks whenever its buffer runs empty, and logs
+   * its reservations if audit is true.
+   */
+  consumer make_consumer(size_t blocks_per_reservation = 16U,
+                         bool audit = false)
+  {
+    return consumer{*this, blocks_per_reservation, audit};
+  }
+};
+
+/**
+ * A uniform random bit generator, owned by a single thread, that draws the
+ * values of the blocks it reserved from a shared_counter_engine. An audited
+ * consumer keeps a log of its reservations, so that the positions of the
+ * stream that a thread consumed can be reported after a run. Reservations
+ * that continue the previous one extend its range, so a consumer that is
+ * the only one to reserve logs a single range.
+ */
+template <class trait_t, std::unsigned_integral result_t>
+class shared_counter_engine<trait_t, result_t>::consumer
+{
+  shared_counter_engine* m_shared{};
+  size_t m_blocks_per_reservation{};
+  std::vector<result_t> m_buffer{};
+  size_t m_index{};
+  bool m_audit{};
+  std::vector<block_range> m_reservations{};
+
+  void refill()
+  {
+    const block_range range = m_shared->reserve(m_blocks_per_reservation);
+    m_shared->fill(range, m_buffer);
+    m_index = 0U;
+    if (!m_audit)
+    {
+      return;
+    }
+    if (!m_reservations.empty() &&
+        m_reservations.back().first_block + m_reservations.back().count ==
+            range.first_block)
+    {
+      m_reservations.back().count += range.count;
+    }
+    else
+    {
+      m_reservations.push_back(range);
+    }
+  }
+
+ public:
+  using result_type = result_t;
+
+  consumer(shared_counter_engine& shared, size_t blocks_per_reservation,
+           bool audit = false)
+      : m_shared{&shared},
+        m_blocks_per_reservation{blocks_per_reservation},
+        m_buffer(blocks_per_reservation * block_size),
+        m_index{m_buffer.size()},
+        m_audit{audit}
+  {
+    assert(blocks_per_reservation != 0U);
+  }
+
+  result_t operator()()
+  {
+    if (m_index == m_buffer.size())
+    {
+      refill();
+    }
+    return m_buffer[m_index++];
+  }
+
+  /**
+   * Fills values with the next values.size() outputs of the consumer,
+   * reserving as many blocks as needed.
+   */
+  void generate(std::span<result_t> values)
+  {
+    auto out = values.begin();
+    while (out != values.end())
+    {
+      if (m_index == m_buffer.size())
+      {
+        refill();
+      }
+      const auto count = std::min(m_buffer.size() - m_index,
+                                  static_cast<size_t>(values.end() - out));
+      out = std::copy_n(
+          m_buffer.begin() + static_cast<std::ptrdiff_t>(m_index), count, out);
+      m_index += count;
+    }
+  }
+
+  /**
+   * The ranges this consumer reserved, in the order they were reserved, if
+   * it is audited, otherwise none.
+   */
+  const std::vector<block_range>& reservations() const noexcept
+  {
+    return m_reservations;
+  }
+
+  static constexpr result_t max() noexcept
+  {
+    return std::numeric_limits<result_t>::max();
+  }
+
+  static constexpr result_t min() noexcept
+  {
+    return std::numeric_limits<result_t>::min();
+  }
+};
+
+}  // namespace qtfy::random
+
+#endif
@@ -0,0 +1,364 @@
+#ifndef QTFY_RANDOM_SIMD_HPP
+#define QTFY_RANDOM_SIMD_HPP
+
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include "counter.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define QTFY_RANDOM_VECTOR_EXTENSIONS 1
+#else
+#define QTFY_RANDOM_VECTOR_EXTENSIONS 0
+#endif
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#define QTFY_RANDOM_X86_SIMD 1
+#include <immintrin.h>
+// Kernels are compiled for their instruction set through target attributes,
+// so that they are available regardless of the -march the consumer uses.
+#define QTFY_TARGET_AVX2 __attribute__((target("avx2")))
+#define QTFY_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define QTFY_RANDOM_X86_SIMD 0
+#endif
+
+namespace qtfy::random::simd {
+
+enum class instruction_set
+{
+  scalar,
+  portable,
+  avx2,
+  avx512
+};
+
+/**
+ * The widest instruction set that the current translation unit was compiled
+ * for. The kernels do not depend on it, see active_instruction_set().
+ */
+constexpr instruction_set compiled_instruction_set() noexcept
+{
+#if QTFY_RANDOM_X86_SIMD && defined(__AVX512F__)
+  return instruction_set::avx512;
+#elif QTFY_RANDOM_X86_SIMD && defined(__AVX2__)
+  return instruction_set::avx2;
+#elif QTFY_RANDOM_VECTOR_EXTENSIONS
+  return instruction_set::portable;
+#else
+  return instruction_set::scalar;
+#endif
+}
+
+constexpr std::string_view to_string(instruction_set isa) noexcept
+{
+  switch (isa)
+  {
+    case instruction_set::portable:
+      return "portable";
+    case instruction_set::avx2:
+      return "avx2";
+    case instruction_set::avx512:
+      return "avx512";
+    default:
+      return "scalar";
+  }
+}
+
+/**
+ * The widest instruction set that the cpu running the program supports and
+ * that has a kernel in this build. Unlike compiled_instruction_set() this
+ * does not depend on the -march the translation unit was compiled with.
+ */
+inline instruction_set detected_instruction_set() noexcept
+{
+#if QTFY_RANDOM_X86_SIMD
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    return instruction_set::avx512;
+  }
+  if (__builtin_cpu_supports("avx2"))
+  {
+    return instruction_set::avx2;
+  }
+#endif
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+  return instruction_set::portable;
+#else
+  return instruction_set::scalar;
+#endif
+}
+
+/**
+ * The instruction set whose kernels the batch bijections use. It is the
+ * detected instruction set, unless the environment variable QTFY_RANDOM_SIMD
+ * names a narrower one ("scalar", "portable", "avx2" or "avx512"), which
+ * allows every kernel to be exercised on a single machine. Requests for an
+ * instruction set the cpu does not support are ignored. The selection is
+ * made on the first call and is fixed for the lifetime of the program.
+ */
+inline instruction_set active_instruction_set() noexcept
+{
+  static const instruction_set active = [] {
+    const instruction_set detected = detected_instruction_set();
+    const char* requested = std::getenv("QTFY_RANDOM_SIMD");
+    if (requested == nullptr)
+    {
+      return detected;
+    }
+    for (auto isa : {instruction_set::scalar, instruction_set::portable,
+                     instruction_set::avx2, instruction_set::avx512})
+    {
+      if (to_string(isa) == requested && isa <= detected)
+      {
+        return isa;
+      }
+    }
+    return detected;
+  }();
+  return active;
+}
+
+/**
+ * Transposes lanes consecutive counters into one array per word so that each
+ * array can be loaded into a single vector register.
+ */
+template <size_t lanes, class word_t, size_t words>
+inline void to_lanes(const counter<word_t, words>* counters,
+                     word_t (&lanes_out)[words][lanes]) noexcept
+{
+  for (size_t lane{}; lane < lanes; ++lane)
+  {
+    for (size_t w{}; w < words; ++w)
+    {
+      lanes_out[w][lane] = counters[lane][w];
+    }
+  }
+}
+
+template <size_t lanes, class word_t, size_t words>
+inline void from_lanes(const word_t (&lanes_in)[words][lanes],
+                       counter<word_t, words>* counters) noexcept
+{
+  for (size_t lane{}; lane < lanes; ++lane)
+  {
+    for (size_t w{}; w < words; ++w)
+    {
+      counters[lane][w] = lanes_in[w][lane];
+    }
+  }
+}
+
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+
+/**
+ * The number of bytes in a pack used by the portable kernels. Four 32 bit
+ * or two 64 bit words of eight counters is the widest that keeps the philox
+ * and threefry state in registers on a 16 register sse2 or neon target.
+ */
+constexpr size_t portable_width = 32U;
+
+/**
+ * A thin wrapper around a GCC / Clang vector extension type holding lanes
+ * words. It only provides the operations that the bijections need. The
+ * compiler lowers the operations to whatever vector instructions the
+ * enclosing function is compiled for, which makes the same kernel usable for
+ * any instruction set, or for none at all.
+ */
+template <class word_t, size_t lanes>
+struct pack
+{
+  static_assert(std::is_same_v<word_t, uint32_t> ||
+                std::is_same_v<word_t, uint64_t>);
+  static_assert(lanes % 2U == 0U);
+
+  typedef word_t native_type
+      __attribute__((vector_size(sizeof(word_t) * lanes)));
+  typedef uint64_t wide_type
+      __attribute__((vector_size(sizeof(word_t) * lanes)));
+
+  native_type value;
+
+  static pack broadcast(word_t x) noexcept { return {native_type{} + x}; }
+
+  static pack load(const word_t* data) noexcept
+  {
+    pack result;
+    std::memcpy(&result.value, data, sizeof(native_type));
+    return result;
+  }
+
+  void store(word_t* data) const noexcept
+  {
+    std::memcpy(data, &value, sizeof(native_type));
+  }
+
+  // packs are passed by reference, since GCC notes an ABI change on every
+  // function that takes a vector wider than the baseline registers by value.
+  friend pack operator+(const pack& a, const pack& b) noexcept
+  {
+    return {a.value + b.value};
+  }
+
+  friend pack operator^(const pack& a, const pack& b) noexcept
+  {
+    return {a.value ^ b.value};
+  }
+
+  template <unsigned shift>
+  friend pack rotate_left(const pack& x) noexcept
+  {
+    constexpr unsigned digits = std::numeric_limits<word_t>::digits;
+    constexpr unsigned left_shift = shift % digits;
+    if constexpr (left_shift == 0U)
+    {
+      return x;
+    }
+    else
+    {
+      return {(x.value << left_shift) | (x.value >> (digits - left_shift))};
+    }
+  }
+
+  /**
+   * Computes the high and low halves of the products of every lane with
+   * multiplier. The products are formed from 32 x 32 -> 64 bit multiplies of
+   * masked 64 bit lanes, which compilers map onto widening vector multiplies
+   * such as pmuludq or umull.
+   */
+  template <uint64_t multiplier>
+  friend void mulhilo(const pack& x, pack& hi, pack& lo) noexcept
+  {
+    constexpr uint64_t mask = 0xFFFFFFFFU;
+    if constexpr (std::is_same_v<word_t, uint32_t>)
+    {
+      // every 64 bit lane holds two 32 bit lanes, one of which is multiplied
+      // at a time. This does not depend on the byte order. A cast between
+      // vector types of the same size reinterprets the bits in place, where
+      // std::bit_cast would pass the vector through a function that is not
+      // compiled for its instruction set.
+      const wide_type wide = reinterpret_cast<wide_type>(x.value);
+      const wide_type even = (wide & mask) * multiplier;
+      const wide_type odd = (wide >> 32U) * multiplier;
+      lo.value = reinterpret_cast<native_type>((even & mask) | (odd << 32U));
+      hi.value = reinterpret_cast<native_type>((even >> 32U) | (odd & ~mask));
+    }
+    else
+    {
+      constexpr uint64_t m_lo = multiplier & mask;
+      constexpr uint64_t m_hi = multiplier >> 32U;
+      const wide_type x_lo = x.value & mask;
+      const wide_type x_hi = x.value >> 32U;
+      const wide_type ll = x_lo * m_lo;
+      const wide_type t = x_lo * m_hi + (ll >> 32U);
+      const wide_type tl = x_hi * m_lo + (t & mask);
+      hi.value = x_hi * m_hi + (t >> 32U) + (tl >> 32U);
+      lo.value = (tl << 32U) | (ll & mask);
+    }
+  }
+};
+
+#endif
+
+#if QTFY_RANDOM_X86_SIMD
+
+template <class word_t>
+QTFY_TARGET_AVX2 inline __m256i broadcast_avx2(word_t x) noexcept
+{
+  if constexpr (std::is_same_v<word_t, uint32_t>)
+  {
+    return _mm256_set1_epi32(static_cast<int>(x));
+  }
+  else
+  {
+    return _mm256_set1_epi64x(static_cast<long long>(x));
+  }
+}
+
+template <class word_t>
+QTFY_TARGET_AVX2 inline __m256i add_avx2(__m256i a, __m256i b) noexcept
+{
+  if constexpr (std::is_same_v<word_t, uint32_t>)
+  {
+    return _mm256_add_epi32(a, b);
+  }
+  else
+  {
+    return _mm256_add_epi64(a, b);
+  }
+}
+
+template <class word_t, unsigned shift>
+QTFY_TARGET_AVX2 inline __m256i rotate_left_avx2(__m256i x) noexcept
+{
+  constexpr unsigned digits = std::numeric_limits<word_t>::digits;
+  constexpr int left_shift = shift % digits;
+  constexpr int right_shift = digits - left_shift;
+  if constexpr (left_shift == 0)
+  {
+    return x;
+  }
+  else if constexpr (std::is_same_v<word_t, uint32_t>)
+  {
+    return _mm256_or_si256(_mm256_slli_epi32(x, left_shift),
+                           _mm256_srli_epi32(x, right_shift));
+  }
+  else
+  {
+    return _mm256_or_si256(_mm256_slli_epi64(x, left_shift),
+                           _mm256_srli_epi64(x, right_shift));
+  }
+}
+
+template <class word_t>
+QTFY_TARGET_AVX512 inline __m512i broadcast_avx512(word_t x) noexcept
+{
+  if constexpr (std::is_same_v<word_t, uint32_t>)
+  {
+    return _mm512_set1_epi32(static_cast<int>(x));
+  }
+  else
+  {
+    return _mm512_set1_epi64(static_cast<long long>(x));
+  }
+}
+
+template <class word_t>
+QTFY_TARGET_AVX512 inline __m512i add_avx512(__m512i a, __m512i b) noexcept
+{
+  if constexpr (std::is_same_v<word_t, uint32_t>)
+  {
+    return _mm512_add_epi32(a, b);
+  }
+  else
+  {
+    return _mm512_add_epi64(a, b);
+  }
+}
+
+// avx512 has native rotate instructions (vprold / vprolq). The zero masked
+// forms are used, since the unmasked ones pass an undefined vector through,
+// which GCC reports as uninitialized once they are inlined.
+template <class word_t, unsigned shift>
+QTFY_TARGET_AVX512 inline __m512i rotate_left_avx512(__m512i x) noexcept
+{
+  constexpr int left_shift = shift % std::numeric_limits<word_t>::digits;
+  if constexpr (left_shift == 0)
+  {
+    return x;
+  }
+  else if constexpr (std::is_same_v<word_t, uint32_t>)
+  {
+    return _mm512_maskz_rol_epi32(0xFFFF, x, left_shift);
+  }
+  else
+  {
+    return _mm512_maskz_rol_epi64(0xFF, x, left_shift);
+  }
+}
+
+#endif
+
+}  // namespace qtfy::random::simd
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef QTFY_RANDOM_STATIC_KEY_COUNTER_ENGINE_HPP
+#define QTFY_RANDOM_STATIC_KEY_COUNTER_ENGINE_HPP
+
+#include <span>
+#include "counter_based_engine.hpp"
+
+namespace qtfy::random {
+
+/**
+ * trait_t with its key fixed at compile time. The bijection is the one
+ * trait_t::make_bijection<key>() returns, so the compiler can fold the key
+ * injections and round keys into immediates. The internal key is empty,
+ * which also makes the key part of an engine's state free.
+ *
+ * key_type is empty as well, so a runtime key cannot be passed by mistake
+ * to an engine whose key is fixed.
+ */
+template <class trait_t, typename trait_t::key_type key>
+class static_key_trait
+{
+  static constexpr auto fixed_bijection =
+      trait_t::template make_bijection<key>();
+
+ public:
+  using counter_type = typename trait_t::counter_type;
+  using word_type = typename trait_t::word_type;
+  using base_key_type = typename trait_t::key_type;
+
+  struct key_type
+  {
+    friend constexpr bool operator==(key_type, key_type) noexcept = default;
+  };
+
+  struct internal_key_type
+  {
+    friend constexpr bool operator==(internal_key_type,
+                                     internal_key_type) noexcept = default;
+  };
+
+  static constexpr base_key_type fixed_key = key;
+
+  static constexpr internal_key_type set_key(key_type) noexcept { return {}; }
+
+  static constexpr counter_type bijection(counter_type counter,
+                                          internal_key_type) noexcept
+  {
+    return fixed_bijection(counter);
+  }
+
+  /**
+   * The batch bijection of trait_t with the internal key of fixed_key, which
+   * is computed at compile time. The simd kernels broadcast the key once
+   * per call, so there is nothing left to fold for them.
+   */
+  static constexpr void bijection_batch(std::span<const counter_type> counters,
+                                        std::span<counter_type> results,
+                                        internal_key_type) noexcept
+  {
+    constexpr auto internal_key = trait_t::set_key(key);
+    trait_t::bijection_batch(counters, results, internal_key);
+  }
+};
+
+/**
+ * counter_based_engine with a key fixed at compile time. It has every
+ * feature of counter_based_engine, including bulk generation, canonical
+ * values, random access and substreams, and draws the same values as
+ * counter_based_engine<trait_t, result_t, depth>{key, counter}.
+ */
+template <class trait_t, typename trait_t::key_type key,
+          std::unsigned_integral result_t = typename trait_t::word_type,
+          size_t depth = 1U>
+using static_key_counter_engine =
+    counter_based_engine<static_key_trait<trait_t, key>, result_t, depth>;
+
+}  // namespace qtfy::random
+
+#endif
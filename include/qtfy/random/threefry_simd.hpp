@@ -0,0 +1,610 @@
+#ifndef QTFY_RANDOM_THREEFRY_SIMD_HPP
+#define QTFY_RANDOM_THREEFRY_SIMD_HPP
+
+#include "counter.hpp"
+#include "simd.hpp"
+
+namespace qtfy::random {
+
+template <std::unsigned_integral word_t, size_t words, unsigned rounds,
+          std::array<word_t, 2> tweaks, word_t parity,
+          std::array<std::array<unsigned, 8>, words / 2> rotations>
+class threefry_trait;
+
+}  // namespace qtfy::random
+
+namespace qtfy::random::simd {
+
+template <class trait_t>
+struct threefry_kernel;
+
+/**
+ * Multi lane threefry kernels with the same contract as philox_kernel. The
+ * round structure is unrolled at compile time exactly as in
+ * threefry_trait::round_applier, so the rotation amounts stay immediates:
+ * avx512 uses the native vprold / vprolq rotates and avx2 a pair of shifts.
+ * The extended key, including the parity word, and the tweak are broadcast
+ * once per call, so the tweak can be chosen at runtime at no extra cost.
+ * The portable kernel is the same round structure written against
+ * simd::pack, which the compiler lowers to any available vector unit.
+ */
+template <std::unsigned_integral word_t, size_t words, unsigned rounds,
+          std::array<word_t, 2> tweaks, word_t parity,
+          std::array<std::array<unsigned, 8>, words / 2> rotations>
+struct threefry_kernel<
+    threefry_trait<word_t, words, rounds, tweaks, parity, rotations>>
+{
+  using counter_type = counter<word_t, words>;
+  using key_type = counter<word_t, words>;
+  using internal_key_type = counter<word_t, words + 1U>;
+  using tweak_type = std::array<word_t, 2>;
+
+#if QTFY_RANDOM_X86_SIMD || QTFY_RANDOM_VECTOR_EXTENSIONS
+ private:
+  static constexpr size_t key_size = words + 1U;
+#endif
+
+#if QTFY_RANDOM_X86_SIMD
+ private:
+  template <word_t s>
+  QTFY_TARGET_AVX2 static void bump_counter_avx2(
+      __m256i (&ctr)[words], const __m256i (&key)[key_size],
+      const __m256i (&tweak)[3]) noexcept
+  {
+    const __m256i injection = broadcast_avx2<word_t>(s);
+    if constexpr (words == 2U)
+    {
+      ctr[0U] = add_avx2<word_t>(ctr[0U], key[(s + 0U) % key_size]);
+      ctr[1U] = add_avx2<word_t>(
+          ctr[1U], add_avx2<word_t>(key[(s + 1U) % key_size], injection));
+    }
+    if constexpr (words == 4U)
+    {
+      ctr[0U] = add_avx2<word_t>(ctr[0U], key[(s + 0U) % key_size]);
+      ctr[1U] = add_avx2<word_t>(
+          ctr[1U], add_avx2<word_t>(key[(s + 1U) % key_size], tweak[s % 3U]));
+      ctr[2U] = add_avx2<word_t>(
+          ctr[2U],
+          add_avx2<word_t>(key[(s + 2U) % key_size], tweak[(s + 1U) % 3U]));
+      ctr[3U] = add_avx2<word_t>(
+          ctr[3U], add_avx2<word_t>(key[(s + 3U) % key_size], injection));
+    }
+  }
+
+  template <size_t i0, size_t i1, unsigned rotation>
+  QTFY_TARGET_AVX2 static void mix_avx2(__m256i (&ctr)[words]) noexcept
+  {
+    ctr[i0] = add_avx2<word_t>(ctr[i0], ctr[i1]);
+    ctr[i1] = _mm256_xor_si256(rotate_left_avx2<word_t, rotation>(ctr[i1]),
+                               ctr[i0]);
+  }
+
+  template <unsigned r>
+  QTFY_TARGET_AVX2 static void round_applier_avx2(
+      __m256i (&ctr)[words], const __m256i (&key)[key_size],
+      const __m256i (&tweak)[3]) noexcept
+  {
+    constexpr bool is_even = (r % 2U) == 0U;
+    if constexpr (words == 2U)
+    {
+      mix_avx2<0U, 1U, rotations[0U][r % 8U]>(ctr);
+    }
+    if constexpr (words == 4U)
+    {
+      mix_avx2<0U, is_even ? 1U : 3U, rotations[0U][r % 8U]>(ctr);
+      mix_avx2<2U, is_even ? 3U : 1U, rotations[1U][r % 8U]>(ctr);
+    }
+
+    if constexpr ((r + 1U) % 4U == 0U)
+    {
+      bump_counter_avx2<(r + 1U) / 4U>(ctr, key, tweak);
+    }
+
+    if constexpr (r + 1U < rounds)
+    {
+      round_applier_avx2<r + 1U>(ctr, key, tweak);
+    }
+  }
+
+  template <word_t s>
+  QTFY_TARGET_AVX512 static void bump_counter_avx512(
+      __m512i (&ctr)[words], const __m512i (&key)[key_size],
+      const __m512i (&tweak)[3]) noexcept
+  {
+    const __m512i injection = broadcast_avx512<word_t>(s);
+    if constexpr (words == 2U)
+    {
+      ctr[0U] = add_avx512<word_t>(ctr[0U], key[(s + 0U) % key_size]);
+      ctr[1U] = add_avx512<word_t>(
+          ctr[1U], add_avx512<word_t>(key[(s + 1U) % key_size], injection));
+    }
+    if constexpr (words == 4U)
+    {
+      ctr[0U] = add_avx512<word_t>(ctr[0U], key[(s + 0U) % key_size]);
+      ctr[1U] = add_avx512<word_t>(
+          ctr[1U],
+          add_avx512<word_t>(key[(s + 1U) % key_size], tweak[s % 3U]));
+      ctr[2U] = add_avx512<word_t>(
+          ctr[2U],
+          add_avx512<word_t>(key[(s + 2U) % key_size], tweak[(s + 1U) % 3U]));
+      ctr[3U] = add_avx512<word_t>(
+          ctr[3U], add_avx512<word_t>(key[(s + 3U) % key_size], injection));
+    }
+  }
+
+  template <size_t i0, size_t i1, unsigned rotation>
+  QTFY_TARGET_AVX512 static void mix_avx512(__m512i (&ctr)[words]) noexcept
+  {
+    ctr[i0] = add_avx512<word_t>(ctr[i0], ctr[i1]);
+    ctr[i1] = _mm512_xor_si512(rotate_left_avx512<word_t, rotation>(ctr[i1]),
+                               ctr[i0]);
+  }
+
+  template <unsigned r>
+  QTFY_TARGET_AVX512 static void round_applier_avx512(
+      __m512i (&ctr)[words], const __m512i (&key)[key_size],
+      const __m512i (&tweak)[3]) noexcept
+  {
+    constexpr bool is_even = (r % 2U) == 0U;
+    if constexpr (words == 2U)
+    {
+      mix_avx512<0U, 1U, rotations[0U][r % 8U]>(ctr);
+    }
+    if constexpr (words == 4U)
+    {
+      mix_avx512<0U, is_even ? 1U : 3U, rotations[0U][r % 8U]>(ctr);
+      mix_avx512<2U, is_even ? 3U : 1U, rotations[1U][r % 8U]>(ctr);
+    }
+
+    if constexpr ((r + 1U) % 4U == 0U)
+    {
+      bump_counter_avx512<(r + 1U) / 4U>(ctr, key, tweak);
+    }
+
+    if constexpr (r + 1U < rounds)
+    {
+      round_applier_avx512<r + 1U>(ctr, key, tweak);
+    }
+  }
+
+ public:
+  QTFY_TARGET_AVX2 static size_t avx2(const counter_type* counters,
+                                      counter_type* results, size_t count,
+                                      internal_key_type key,
+                                      tweak_type tweak = tweaks) noexcept
+  {
+    constexpr size_t lanes = sizeof(__m256i) / sizeof(word_t);
+    const size_t full = count - count % lanes;
+
+    __m256i extended_key[key_size];
+    for (size_t i{}; i < key_size; ++i)
+    {
+      extended_key[i] = broadcast_avx2<word_t>(key[i]);
+    }
+    const __m256i extended_tweak[3]{
+        broadcast_avx2<word_t>(tweak[0U]), broadcast_avx2<word_t>(tweak[1U]),
+        broadcast_avx2<word_t>(tweak[0U] ^ tweak[1U])};
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      alignas(__m256i) word_t lanes_data[words][lanes];
+      to_lanes(counters + i, lanes_data);
+
+      __m256i ctr[words];
+      for (size_t w{}; w < words; ++w)
+      {
+        ctr[w] = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(lanes_data[w]));
+      }
+
+      if constexpr (rounds != 0U)
+      {
+        bump_counter_avx2<0U>(ctr, extended_key, extended_tweak);
+        round_applier_avx2<0U>(ctr, extended_key, extended_tweak);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_data[w]), ctr[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+
+  QTFY_TARGET_AVX512 static size_t avx512(const counter_type* counters,
+                                          counter_type* results, size_t count,
+                                          internal_key_type key,
+                                          tweak_type tweak = tweaks) noexcept
+  {
+    constexpr size_t lanes = sizeof(__m512i) / sizeof(word_t);
+    const size_t full = count - count % lanes;
+
+    __m512i extended_key[key_size];
+    for (size_t i{}; i < key_size; ++i)
+    {
+      extended_key[i] = broadcast_avx512<word_t>(key[i]);
+    }
+    const __m512i extended_tweak[3]{
+        broadcast_avx512<word_t>(tweak[0U]),
+        broadcast_avx512<word_t>(tweak[1U]),
+        broadcast_avx512<word_t>(tweak[0U] ^ tweak[1U])};
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      alignas(__m512i) word_t lanes_data[words][lanes];
+      to_lanes(counters + i, lanes_data);
+
+      __m512i ctr[words];
+      for (size_t w{}; w < words; ++w)
+      {
+        ctr[w] = _mm512_load_si512(lanes_data[w]);
+      }
+
+      if constexpr (rounds != 0U)
+      {
+        bump_counter_avx512<0U>(ctr, extended_key, extended_tweak);
+        round_applier_avx512<0U>(ctr, extended_key, extended_tweak);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        _mm512_store_si512(lanes_data[w], ctr[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+
+  /**
+   * Applies the bijection of the key keys[i] to ctr for lanes keys at a
+   * time. The keys are transposed like the counters of avx2, the parity word
+   * of set_key is computed in the vector registers, and ctr is broadcast.
+   */
+  QTFY_TARGET_AVX2 static size_t avx2_keys(counter_type ctr,
+                                           const key_type* keys,
+                                           counter_type* results,
+                                           size_t count) noexcept
+  {
+    constexpr size_t lanes = sizeof(__m256i) / sizeof(word_t);
+    const size_t full = count - count % lanes;
+
+    __m256i counter_words[words];
+    for (size_t w{}; w < words; ++w)
+    {
+      counter_words[w] = broadcast_avx2<word_t>(ctr[w]);
+    }
+    const __m256i extended_tweak[3]{
+        broadcast_avx2<word_t>(tweaks[0U]), broadcast_avx2<word_t>(tweaks[1U]),
+        broadcast_avx2<word_t>(tweaks[0U] ^ tweaks[1U])};
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      alignas(__m256i) word_t lanes_data[words][lanes];
+      to_lanes(keys + i, lanes_data);
+
+      __m256i extended_key[key_size];
+      extended_key[words] = broadcast_avx2<word_t>(parity);
+      for (size_t w{}; w < words; ++w)
+      {
+        extended_key[w] = _mm256_load_si256(
+            reinterpret_cast<const __m256i*>(lanes_data[w]));
+        extended_key[words] =
+            _mm256_xor_si256(extended_key[words], extended_key[w]);
+      }
+
+      __m256i block[words];
+      for (size_t w{}; w < words; ++w)
+      {
+        block[w] = counter_words[w];
+      }
+      if constexpr (rounds != 0U)
+      {
+        bump_counter_avx2<0U>(block, extended_key, extended_tweak);
+        round_applier_avx2<0U>(block, extended_key, extended_tweak);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(lanes_data[w]),
+                           block[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+
+  QTFY_TARGET_AVX512 static size_t avx512_keys(counter_type ctr,
+                                               const key_type* keys,
+                                               counter_type* results,
+                                               size_t count) noexcept
+  {
+    constexpr size_t lanes = sizeof(__m512i) / sizeof(word_t);
+    const size_t full = count - count % lanes;
+
+    __m512i counter_words[words];
+    for (size_t w{}; w < words; ++w)
+    {
+      counter_words[w] = broadcast_avx512<word_t>(ctr[w]);
+    }
+    const __m512i extended_tweak[3]{
+        broadcast_avx512<word_t>(tweaks[0U]),
+        broadcast_avx512<word_t>(tweaks[1U]),
+        broadcast_avx512<word_t>(tweaks[0U] ^ tweaks[1U])};
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      alignas(__m512i) word_t lanes_data[words][lanes];
+      to_lanes(keys + i, lanes_data);
+
+      __m512i extended_key[key_size];
+      extended_key[words] = broadcast_avx512<word_t>(parity);
+      for (size_t w{}; w < words; ++w)
+      {
+        extended_key[w] = _mm512_load_si512(lanes_data[w]);
+        extended_key[words] =
+            _mm512_xor_si512(extended_key[words], extended_key[w]);
+      }
+
+      __m512i block[words];
+      for (size_t w{}; w < words; ++w)
+      {
+        block[w] = counter_words[w];
+      }
+      if constexpr (rounds != 0U)
+      {
+        bump_counter_avx512<0U>(block, extended_key, extended_tweak);
+        round_applier_avx512<0U>(block, extended_key, extended_tweak);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        _mm512_store_si512(lanes_data[w], block[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+#endif
+
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+ private:
+  template <word_t s, size_t lanes>
+  static void bump_counter_portable(
+      pack<word_t, lanes> (&ctr)[words],
+      const pack<word_t, lanes> (&key)[key_size],
+      const pack<word_t, lanes> (&tweak)[3]) noexcept
+  {
+    using pack_type = pack<word_t, lanes>;
+    const pack_type injection = pack_type::broadcast(s);
+    if constexpr (words == 2U)
+    {
+      ctr[0U] = ctr[0U] + key[(s + 0U) % key_size];
+      ctr[1U] = ctr[1U] + key[(s + 1U) % key_size] + injection;
+    }
+    if constexpr (words == 4U)
+    {
+      ctr[0U] = ctr[0U] + key[(s + 0U) % key_size];
+      ctr[1U] = ctr[1U] + key[(s + 1U) % key_size] + tweak[s % 3U];
+      ctr[2U] = ctr[2U] + key[(s + 2U) % key_size] + tweak[(s + 1U) % 3U];
+      ctr[3U] = ctr[3U] + key[(s + 3U) % key_size] + injection;
+    }
+  }
+
+  template <size_t i0, size_t i1, unsigned rotation, size_t lanes>
+  static void mix_portable(pack<word_t, lanes> (&ctr)[words]) noexcept
+  {
+    ctr[i0] = ctr[i0] + ctr[i1];
+    ctr[i1] = rotate_left<rotation>(ctr[i1]) ^ ctr[i0];
+  }
+
+  template <unsigned r, size_t lanes>
+  static void round_applier_portable(
+      pack<word_t, lanes> (&ctr)[words],
+      const pack<word_t, lanes> (&key)[key_size],
+      const pack<word_t, lanes> (&tweak)[3]) noexcept
+  {
+    constexpr bool is_even = (r % 2U) == 0U;
+    if constexpr (words == 2U)
+    {
+      mix_portable<0U, 1U, rotations[0U][r % 8U]>(ctr);
+    }
+    if constexpr (words == 4U)
+    {
+      mix_portable<0U, is_even ? 1U : 3U, rotations[0U][r % 8U]>(ctr);
+      mix_portable<2U, is_even ? 3U : 1U, rotations[1U][r % 8U]>(ctr);
+    }
+
+    if constexpr ((r + 1U) % 4U == 0U)
+    {
+      bump_counter_portable<(r + 1U) / 4U>(ctr, key, tweak);
+    }
+
+    if constexpr (r + 1U < rounds)
+    {
+      round_applier_portable<r + 1U>(ctr, key, tweak);
+    }
+  }
+
+ public:
+  template <size_t width = portable_width>
+  static size_t portable(const counter_type* counters, counter_type* results,
+                         size_t count, internal_key_type key,
+                         tweak_type tweak = tweaks) noexcept
+  {
+    constexpr size_t lanes = width / sizeof(word_t);
+    using pack_type = pack<word_t, lanes>;
+    const size_t full = count - count % lanes;
+
+    pack_type extended_key[key_size];
+    for (size_t i{}; i < key_size; ++i)
+    {
+      extended_key[i] = pack_type::broadcast(key[i]);
+    }
+    const pack_type extended_tweak[3]{
+        pack_type::broadcast(tweak[0U]), pack_type::broadcast(tweak[1U]),
+        pack_type::broadcast(tweak[0U] ^ tweak[1U])};
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      word_t lanes_data[words][lanes];
+      to_lanes(counters + i, lanes_data);
+
+      pack_type ctr[words];
+      for (size_t w{}; w < words; ++w)
+      {
+        ctr[w] = pack_type::load(lanes_data[w]);
+      }
+
+      if constexpr (rounds != 0U)
+      {
+        bump_counter_portable<0U>(ctr, extended_key, extended_tweak);
+        round_applier_portable<0U>(ctr, extended_key, extended_tweak);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        ctr[w].store(lanes_data[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+
+  template <size_t width = portable_width>
+  static size_t portable_keys(counter_type ctr, const key_type* keys,
+                              counter_type* results, size_t count) noexcept
+  {
+    constexpr size_t lanes = width / sizeof(word_t);
+    using pack_type = pack<word_t, lanes>;
+    const size_t full = count - count % lanes;
+
+    pack_type counter_words[words];
+    for (size_t w{}; w < words; ++w)
+    {
+      counter_words[w] = pack_type::broadcast(ctr[w]);
+    }
+    const pack_type extended_tweak[3]{
+        pack_type::broadcast(tweaks[0U]), pack_type::broadcast(tweaks[1U]),
+        pack_type::broadcast(tweaks[0U] ^ tweaks[1U])};
+
+    for (size_t i{}; i != full; i += lanes)
+    {
+      word_t lanes_data[words][lanes];
+      to_lanes(keys + i, lanes_data);
+
+      pack_type extended_key[key_size];
+      extended_key[words] = pack_type::broadcast(parity);
+      for (size_t w{}; w < words; ++w)
+      {
+        extended_key[w] = pack_type::load(lanes_data[w]);
+        extended_key[words] = extended_key[words] ^ extended_key[w];
+      }
+
+      pack_type block[words];
+      for (size_t w{}; w < words; ++w)
+      {
+        block[w] = counter_words[w];
+      }
+      if constexpr (rounds != 0U)
+      {
+        bump_counter_portable<0U>(block, extended_key, extended_tweak);
+        round_applier_portable<0U>(block, extended_key, extended_tweak);
+      }
+
+      for (size_t w{}; w < words; ++w)
+      {
+        block[w].store(lanes_data[w]);
+      }
+      from_lanes(lanes_data, results + i);
+    }
+    return full;
+  }
+#endif
+
+  using kernel_type = size_t (*)(const counter_type*, counter_type*, size_t,
+                                 internal_key_type, tweak_type) noexcept;
+
+  static size_t scalar(const counter_type*, counter_type*, size_t,
+                       internal_key_type, tweak_type = tweaks) noexcept
+  {
+    return 0U;
+  }
+
+  /**
+   * The kernel for active_instruction_set().
+   */
+  static kernel_type select() noexcept
+  {
+    switch (active_instruction_set())
+    {
+#if QTFY_RANDOM_X86_SIMD
+      case instruction_set::avx512:
+        return avx512;
+      case instruction_set::avx2:
+        return avx2;
+#endif
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+      case instruction_set::portable:
+        return portable;
+#endif
+      default:
+        return scalar;
+    }
+  }
+
+  /**
+   * Runs the kernel for active_instruction_set() and returns the number of
+   * counters that were processed. The kernel is selected on the first call.
+   */
+  static size_t run(const counter_type* counters, counter_type* results,
+                    size_t count, internal_key_type key,
+                    tweak_type tweak = tweaks) noexcept
+  {
+    static const kernel_type kernel = select();
+    return kernel(counters, results, count, key, tweak);
+  }
+
+  using keys_kernel_type = size_t (*)(counter_type, const key_type*,
+                                      counter_type*, size_t) noexcept;
+
+  static size_t scalar_keys(counter_type, const key_type*, counter_type*,
+                            size_t) noexcept
+  {
+    return 0U;
+  }
+
+  static keys_kernel_type select_keys() noexcept
+  {
+    switch (active_instruction_set())
+    {
+#if QTFY_RANDOM_X86_SIMD
+      case instruction_set::avx512:
+        return avx512_keys;
+      case instruction_set::avx2:
+        return avx2_keys;
+#endif
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+      case instruction_set::portable:
+        return portable_keys;
+#endif
+      default:
+        return scalar_keys;
+    }
+  }
+
+  /**
+   * Runs the kernel over keys for active_instruction_set() and returns the
+   * number of keys that were processed.
+   */
+  static size_t run_keys(counter_type ctr, const key_type* keys,
+                         counter_type* results, size_t count) noexcept
+  {
+    static const keys_kernel_type kernel = select_keys();
+    return kernel(ctr, keys, results, count);
+  }
+};
+
+}  // namespace qtfy::random::simd
+
+#endif
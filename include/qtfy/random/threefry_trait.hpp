@@ -1,7 +1,12 @@
 #ifndef QTFY_RANDOM_THREEFRY_TRAIT_HPP
 #define QTFY_RANDOM_THREEFRY_TRAIT_HPP
 
+#include <algorithm>
+#include <span>
+#include <utility>
 #include "counter.hpp"
+#include "kernels.hpp"
+#include "threefry_simd.hpp"
 
 namespace qtfy::random {
 
@@ -15,19 +20,41 @@ class threefry_trait
   using key_type = counter<word_t, words>;
   using internal_key_type = counter<word_t, words + 1U>;
   using word_type = word_t;
+  // the tweak words t0 and t1. Only four word threefry mixes in the tweak,
+  // two word threefry has none, as in Random123.
+  using tweak_type = std::array<word_t, 2>;
+
+  static constexpr tweak_type default_tweak = tweaks;
 
  private:
+  using extended_tweak_type = std::array<word_t, 3>;
+
+  static constexpr extended_tweak_type extend_tweak(tweak_type tweak) noexcept
+  {
+    return {tweak[0], tweak[1], tweak[0] ^ tweak[1]};
+  }
+
   static_assert(words == 2U || words == 4U);
   static_assert(std::is_same_v<word_t, uint32_t> ||
                 std::is_same_v<word_t, uint64_t>);
   static_assert(rounds <= 72U);
 
-  static constexpr std::array<word_t, 3> extended_tweaks{tweaks[0], tweaks[1],
-                                                         tweaks[0] ^ tweaks[1]};
+  static constexpr extended_tweak_type extended_tweaks = extend_tweak(tweaks);
 
-  template <unsigned r>
-  static constexpr auto bump_counter(counter_type ctr,
-                                     internal_key_type key) noexcept
+  // stands in for extended_tweaks, so that the tweak words of the compile
+  // time tweak stay constants in the unrolled rounds instead of being loaded
+  // from a runtime argument.
+  struct fixed_tweak
+  {
+    constexpr word_t operator[](size_t i) const noexcept
+    {
+      return extended_tweaks[i];
+    }
+  };
+
+  template <unsigned r, class tweak_t>
+  static constexpr auto bump_counter(counter_type ctr, internal_key_type key,
+                                     tweak_t extended_tweak) noexcept
   {
     constexpr size_t key_size = internal_key_type{}.size();
     constexpr word_t s = (r + 1U) / 4U;
@@ -40,8 +67,8 @@ class threefry_trait
     if constexpr (words == 4)
     {
       ctr[0U] += key[(s + 0U) % key_size];
-      ctr[1U] += key[(s + 1U) % key_size] + extended_tweaks[s % 3U];
-      ctr[2U] += key[(s + 2U) % key_size] + extended_tweaks[(s + 1) % 3U];
+      ctr[1U] += key[(s + 1U) % key_size] + extended_tweak[s % 3U];
+      ctr[2U] += key[(s + 2U) % key_size] + extended_tweak[(s + 1) % 3U];
       ctr[3U] += key[(s + 3U) % key_size] + s;
     }
 
@@ -70,25 +97,10 @@ class threefry_trait
     return ctr;
   }
 
-  template <unsigned shift>
-  static constexpr auto rotate_left(word_t word) noexcept
-  {
-    constexpr unsigned digits = std::numeric_limits<decltype(word)>::digits;
-    constexpr unsigned left_shift = shift % digits;
-    constexpr unsigned right_shift = digits - left_shift;
-    if constexpr (left_shift != 0U)
-    {
-      return (word << left_shift) | (word >> right_shift);
-    }
-    else
-    {
-      return word;
-    }
-  }
-
   template <unsigned r>
   static constexpr auto round(counter_type ctr) noexcept
   {
+    using namespace qtfy::random::utilities;
     if constexpr (words == 2U)
     {
       ctr[0U] += ctr[1U];
@@ -110,19 +122,20 @@ class threefry_trait
     return ctr;
   }
 
-  template <unsigned r>
+  template <unsigned r, class tweak_t>
   static constexpr auto round_applier(counter_type counter,
-                                      internal_key_type key) noexcept
+                                      internal_key_type key,
+                                      tweak_t extended_tweak) noexcept
   {
     counter = round<r>(counter);
     if constexpr ((r + 1U) % 4U == 0U)
     {
-      counter = bump_counter<r>(counter, key);
+      counter = bump_counter<r>(counter, key, extended_tweak);
     }
 
     if constexpr (r + 1U < rounds)
     {
-      return round_applier<r + 1U>(counter, key);
+      return round_applier<r + 1U>(counter, key, extended_tweak);
     }
     else
     {
@@ -130,6 +143,84 @@ class threefry_trait
     }
   }
 
+  template <unsigned r, size_t n, class tweak_t>
+  static constexpr void round_applier_n(std::array<counter_type, n>& ctrs,
+                                        internal_key_type key,
+                                        tweak_t extended_tweak) noexcept
+  {
+    [&]<size_t... i>(std::index_sequence<i...>)
+    {
+      ((ctrs[i] = round<r>(ctrs[i])), ...);
+      if constexpr ((r + 1U) % 4U == 0U)
+      {
+        ((ctrs[i] = bump_counter<r>(ctrs[i], key, extended_tweak)), ...);
+      }
+    }
+    (std::make_index_sequence<n>{});
+
+    if constexpr (r + 1U < rounds)
+    {
+      round_applier_n<r + 1U>(ctrs, key, extended_tweak);
+    }
+  }
+
+  template <size_t n, class tweak_t>
+  static constexpr std::array<counter_type, n> bijection_n(
+      std::array<counter_type, n> ctrs, internal_key_type key,
+      tweak_t extended_tweak) noexcept
+  {
+    if constexpr (rounds != 0U)
+    {
+      for (auto& ctr : ctrs)
+      {
+        ctr = bump_counter<0U>(ctr, key, extended_tweak);
+      }
+      round_applier_n<0U>(ctrs, key, extended_tweak);
+    }
+    return ctrs;
+  }
+
+  template <class tweak_t>
+  static constexpr counter_type apply_rounds(counter_type counter,
+                                             internal_key_type key,
+                                             tweak_t extended_tweak) noexcept
+  {
+    if constexpr (rounds != 0U)
+    {
+      counter = bump_counter<0U>(counter, key, extended_tweak);
+      return round_applier<0U>(counter, key, extended_tweak);
+    }
+    return counter;
+  }
+
+  template <class tweak_t>
+  static constexpr void apply_rounds_batch(
+      std::span<const counter_type> counters, std::span<counter_type> results,
+      internal_key_type key, tweak_type tweak,
+      tweak_t extended_tweak) noexcept
+  {
+    size_t done{};
+    if (!std::is_constant_evaluated())
+    {
+      done = simd::threefry_kernel<threefry_trait>::run(
+          counters.data(), results.data(), counters.size(), key, tweak);
+    }
+    size_t i{done};
+    for (; counters.size() - i >= interleave; i += interleave)
+    {
+      std::array<counter_type, interleave> group{};
+      std::copy_n(counters.begin() + static_cast<std::ptrdiff_t>(i),
+                  interleave, group.begin());
+      group = bijection_n(group, key, extended_tweak);
+      std::copy(group.begin(), group.end(),
+                results.begin() + static_cast<std::ptrdiff_t>(i));
+    }
+    for (; i < counters.size(); ++i)
+    {
+      results[i] = apply_rounds(counters[i], key, extended_tweak);
+    }
+  }
+
   template <unsigned r, internal_key_type key>
   static constexpr auto round_applier(counter_type counter) noexcept
   {
@@ -165,12 +256,85 @@ class threefry_trait
   static constexpr counter_type bijection(counter_type counter,
                                           internal_key_type key) noexcept
   {
-    if constexpr (rounds != 0U)
+    return apply_rounds(counter, key, fixed_tweak{});
+  }
+
+  /**
+   * The bijection with the tweak given at runtime instead of by the template
+   * parameter. The tweak only enters the key injections, so switching tweaks
+   * needs no set_key, and bijection(c, k, tweaks) is bit identical to
+   * bijection(c, k).
+   */
+  static constexpr counter_type bijection(counter_type counter,
+                                          internal_key_type key,
+                                          tweak_type tweak) noexcept
+  {
+    return apply_rounds(counter, key, extend_tweak(tweak));
+  }
+
+  /**
+   * The number of counters that bijection_batch interleaves when it has no
+   * simd kernel for them.
+   */
+  static constexpr size_t interleave = 4U;
+
+  /**
+   * Applies the bijection to n independent counters at once. The rounds of
+   * all counters are interleaved, so that the add-rotate-xor chains of
+   * different counters overlap instead of running one after the other.
+   */
+  template <size_t n>
+  static constexpr std::array<counter_type, n> bijection_n(
+      std::array<counter_type, n> ctrs, internal_key_type key) noexcept
+  {
+    return bijection_n(ctrs, key, fixed_tweak{});
+  }
+
+  /**
+   * Applies the bijection to every counter in counters and writes the
+   * results to the corresponding position in results, which must be at
+   * least as large as counters. Outside of constant evaluation whole groups
+   * of counters are processed by the widest simd kernel available, and the
+   * rest interleave counters at a time through bijection_n.
+   */
+  static constexpr void bijection_batch(std::span<const counter_type> counters,
+                                        std::span<counter_type> results,
+                                        internal_key_type key) noexcept
+  {
+#if QTFY_RANDOM_LINK_KERNELS
+    if constexpr (kernels::is_compiled<threefry_trait>)
     {
-      counter = bump_counter<0U>(counter, key);
-      return round_applier<0U>(counter, key);
+      if (!std::is_constant_evaluated())
+      {
+        kernels::bijection_batch<threefry_trait>(counters, results, key);
+        return;
+      }
     }
-    return counter;
+#endif
+    bijection_batch_inline(counters, results, key);
+  }
+
+  /**
+   * bijection_batch as implemented in this header, which never forwards to
+   * qtfy_random_kernels. The library builds its kernels from it.
+   */
+  static constexpr void bijection_batch_inline(
+      std::span<const counter_type> counters, std::span<counter_type> results,
+      internal_key_type key) noexcept
+  {
+    apply_rounds_batch(counters, results, key, tweaks, fixed_tweak{});
+  }
+
+  /**
+   * bijection_batch with the tweak given at runtime, bit identical to
+   * bijection_batch(counters, results, key) for tweak == tweaks.
+   */
+  static constexpr void bijection_batch(std::span<const counter_type> counters,
+                                        std::span<counter_type> results,
+                                        internal_key_type key,
+                                        tweak_type tweak) noexcept
+  {
+    apply_rounds_batch(counters, results, key, tweak, extend_tweak(tweak));
   }
 
   static constexpr internal_key_type set_key(key_type key) noexcept
@@ -185,6 +349,30 @@ class threefry_trait
     return result;
   }
 
+  /**
+   * Applies the bijection of every key in keys to the single counter ctr
+   * and writes the results to out, which must be at least as large as keys.
+   * This is the transpose of bijection_batch: outside of constant evaluation
+   * whole groups of keys are processed by the widest simd kernel available,
+   * which expands the keys in its vector registers, and the rest by the
+   * scalar bijection.
+   */
+  static constexpr void bijection_keys(counter_type ctr,
+                                       std::span<const key_type> keys,
+                                       std::span<counter_type> out) noexcept
+  {
+    size_t done{};
+    if (!std::is_constant_evaluated())
+    {
+      done = simd::threefry_kernel<threefry_trait>::run_keys(
+          ctr, keys.data(), out.data(), keys.size());
+    }
+    for (size_t i{done}; i < keys.size(); ++i)
+    {
+      out[i] = bijection(ctr, set_key(keys[i]));
+    }
+  }
+
   static constexpr auto make_bijection(key_type key) noexcept
   {
     return [extended_key = set_key(key)](counter_type ctr) noexcept {
@@ -241,6 +429,90 @@ using threefry2x32_trait =
     threefry2_trait<uint32_t, rounds, t0, t1, 0x1BD11BDA, 13U, 15U, 26U, 6U,
                     17U, 29U, 16U, 24U>;
 
+/**
+ * Four word threefry_t with the tweak held in the internal key instead of
+ * fixed by the template parameter. The tweak only enters the key
+ * injections, so set_tweak selects another stream without running set_key
+ * again and without partitioning the counter space, and for the tweak of
+ * threefry_t the outputs are bit identical to those of threefry_t.
+ */
+template <class threefry_t>
+class threefry_runtime_tweak_trait
+{
+  using base_key_type = typename threefry_t::internal_key_type;
+
+ public:
+  using counter_type = typename threefry_t::counter_type;
+  using key_type = typename threefry_t::key_type;
+  using word_type = typename threefry_t::word_type;
+  using tweak_type = typename threefry_t::tweak_type;
+
+  static_assert(counter_type{}.size() == 4U,
+                "two word threefry does not use the tweak");
+
+  struct internal_key_type
+  {
+    base_key_type key{};
+    tweak_type tweak{};
+
+    friend constexpr bool operator==(const internal_key_type&,
+                                     const internal_key_type&) noexcept =
+        default;
+  };
+
+  static constexpr internal_key_type set_key(
+      key_type key, tweak_type tweak = threefry_t::default_tweak) noexcept
+  {
+    return {threefry_t::set_key(key), tweak};
+  }
+
+  static constexpr internal_key_type set_tweak(internal_key_type key,
+                                               tweak_type tweak) noexcept
+  {
+    key.tweak = tweak;
+    return key;
+  }
+
+  static constexpr counter_type bijection(counter_type counter,
+                                          internal_key_type key) noexcept
+  {
+    return threefry_t::bijection(counter, key.key, key.tweak);
+  }
+
+  static constexpr void bijection_batch(std::span<const counter_type> counters,
+                                        std::span<counter_type> results,
+                                        internal_key_type key) noexcept
+  {
+    threefry_t::bijection_batch(counters, results, key.key, key.tweak);
+  }
+
+  static constexpr auto make_bijection(key_type key, tweak_type tweak) noexcept
+  {
+    return [extended_key = set_key(key, tweak)](counter_type ctr) noexcept {
+      return bijection(ctr, extended_key);
+    };
+  }
+};
+
+template <unsigned rounds>
+using threefry4x64_runtime_tweak_trait =
+    threefry_runtime_tweak_trait<threefry4x64_trait<rounds>>;
+
+template <unsigned rounds>
+using threefry4x32_runtime_tweak_trait =
+    threefry_runtime_tweak_trait<threefry4x32_trait<rounds>>;
+
+#if QTFY_RANDOM_LINK_KERNELS
+template <>
+inline constexpr bool kernels::is_compiled<threefry2x32_trait<20>> = true;
+template <>
+inline constexpr bool kernels::is_compiled<threefry2x64_trait<20>> = true;
+template <>
+inline constexpr bool kernels::is_compiled<threefry4x32_trait<20>> = true;
+template <>
+inline constexpr bool kernels::is_compiled<threefry4x64_trait<20>> = true;
+#endif
+
 template <std::unsigned_integral word_t, size_t words, unsigned rounds, word_t t0, word_t t1>
 requires(std::is_same_v<uint64_t, word_t>&& words == 2)
 constexpr auto threefry_factory(counter<uint64_t, 2> key) noexcept
@@ -6,11 +6,35 @@
 #include <cinttypes>
 #include <cmath>
 #include <limits>
+#include <new>
 #include <type_traits>
 
 namespace qtfy::random {
 using std::size_t;
-}
+
+// the distance between objects written by different threads, so that they
+// do not share a cache line.
+#if defined(QTFY_RANDOM_DESTRUCTIVE_INTERFERENCE_SIZE)
+inline constexpr size_t destructive_interference_size =
+    QTFY_RANDOM_DESTRUCTIVE_INTERFERENCE_SIZE;
+#elif defined(__cpp_lib_hardware_interference_size)
+// GCC warns that the value depends on -mtune. The types aligned to it are
+// not part of an ABI, and QTFY_RANDOM_DESTRUCTIVE_INTERFERENCE_SIZE pins the
+// value where that matters.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winterference-size"
+#endif
+inline constexpr size_t destructive_interference_size =
+    std::hardware_destructive_interference_size;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#else
+inline constexpr size_t destructive_interference_size = 64U;
+#endif
+
+}  // namespace qtfy::random
 
 namespace qtfy::random::utilities {
 
@@ -35,58 +59,148 @@ struct HiLo<T, std::endian::little>
 
 constexpr bool has_unsigned_int128() noexcept
 {
-#if defined(__GNUC__) && defined(__x86_64__)
+#if defined(__SIZEOF_INT128__)
   return true;
 #else
   return false;
 #endif
 }
 
-template <uint64_t left, std::unsigned_integral right_t>
-constexpr auto big_mul(right_t right) noexcept
-{
-  static_assert(std::is_same_v<right_t, uint32_t> ||
-                std::is_same_v<right_t, uint64_t>);
+#if defined(__SIZEOF_INT128__)
+__extension__ typedef unsigned __int128 uint128_t;
+#endif
 
-  using result_t = HiLo<right_t>;
+/**
+ * The full product of left and right, split into its high and low halves.
+ * At runtime 64 bit products use a native 128 bit multiply where the
+ * compiler has one, which lowers to a single mul (or mulx with bmi2).
+ * During constant evaluation, or without 128 bit support, the product is
+ * assembled from four 32 bit partial products. The layout of the result can
+ * be chosen independently of the native byte order so that both layouts can
+ * be tested on any machine.
+ */
+template <std::unsigned_integral word_t,
+          std::endian endian = std::endian::native>
+constexpr auto big_mul(word_t left, word_t right) noexcept
+{
+  using result_t = HiLo<word_t, endian>;
+  result_t result{};
 
-  if constexpr (std::is_same_v<right_t, uint32_t>)
+  if constexpr (sizeof(word_t) < sizeof(uint64_t))
   {
-    return std::bit_cast<result_t>(left * right);
+    constexpr unsigned shift = std::numeric_limits<word_t>::digits;
+    const uint64_t product = uint64_t{left} * right;
+    result.hi = static_cast<word_t>(product >> shift);
+    result.lo = static_cast<word_t>(product);
+    return result;
   }
-  if constexpr (std::is_same_v<right_t, uint64_t>)
+  else
   {
-    constexpr bool use_bit_cast = false;
-    if constexpr (has_unsigned_int128() && use_bit_cast)
-    {
-      constexpr auto big_left = static_cast<unsigned __int128>(left);
-      return std::bit_cast<result_t>(big_left * right);
-    }
-    else
+#if defined(__SIZEOF_INT128__)
+    if (!std::is_constant_evaluated())
     {
-      constexpr uint64_t lower_bits = std::numeric_limits<uint32_t>::max();
-      constexpr uint64_t shift = std::numeric_limits<uint32_t>::digits;
-      constexpr uint64_t a_low = left & lower_bits;
-      constexpr uint64_t a_high = left >> shift;
-      const uint64_t b_low = right & lower_bits;
-      const uint64_t b_high = right >> shift;
-      const uint64_t t = a_high * b_low + (a_low * b_low >> shift);
-      const uint64_t tl = a_low * b_high + (t & lower_bits);
-      const uint64_t low = left * right;
-      const uint64_t high = a_high * b_high + (t >> shift) + (tl >> shift);
-      if constexpr (std::endian::native == std::endian::little)
-      {
-        return result_t{low, high};
-      }
-      //TODO: big endian logic has not been tested.
-      if constexpr (std::endian::native == std::endian::big)
-      {
-        return result_t{high, low};
-      }
+      const uint128_t product = uint128_t{left} * right;
+      result.hi = static_cast<uint64_t>(product >> 64U);
+      result.lo = static_cast<uint64_t>(product);
+      return result;
     }
+#endif
+    constexpr uint64_t lower_bits = std::numeric_limits<uint32_t>::max();
+    constexpr uint64_t shift = std::numeric_limits<uint32_t>::digits;
+    const uint64_t a_low = left & lower_bits;
+    const uint64_t a_high = left >> shift;
+    const uint64_t b_low = right & lower_bits;
+    const uint64_t b_high = right >> shift;
+    const uint64_t t = a_high * b_low + (a_low * b_low >> shift);
+    const uint64_t tl = a_low * b_high + (t & lower_bits);
+    result.lo = left * right;
+    result.hi = a_high * b_high + (t >> shift) + (tl >> shift);
+    return result;
   }
 }
 
+/**
+ * The full product of the constant left and right. left has to fit into
+ * right_t.
+ */
+template <uint64_t left, std::unsigned_integral right_t,
+          std::endian endian = std::endian::native>
+constexpr auto big_mul(right_t right) noexcept
+{
+  static_assert(std::is_same_v<right_t, uint32_t> ||
+                std::is_same_v<right_t, uint64_t>);
+  static_assert(left <= std::numeric_limits<right_t>::max());
+
+  return big_mul<right_t, endian>(static_cast<right_t>(left), right);
+}
+
+/**
+ * Returns left + right + carry and stores the carry out of the addition in
+ * carry. Neither step branches on the carry, so a chain of these compiles to
+ * a sequence of add instructions instead of a loop with a data dependent
+ * exit.
+ */
+template <std::unsigned_integral word_t>
+constexpr word_t add_with_carry(word_t left, word_t right, bool& carry) noexcept
+{
+  const word_t partial = left + right;
+  const word_t sum = partial + static_cast<word_t>(carry);
+  carry = (partial < left) | (sum < partial);
+  return sum;
+}
+
+/**
+ * Returns left - right - borrow and stores the borrow out of the subtraction
+ * in borrow. The counterpart of add_with_carry.
+ */
+template <std::unsigned_integral word_t>
+constexpr word_t subtract_with_borrow(word_t left, word_t right,
+                                      bool& borrow) noexcept
+{
+  const word_t partial = left - right;
+  const word_t difference = partial - static_cast<word_t>(borrow);
+  borrow = (partial > left) | (difference > partial);
+  return difference;
+}
+
+/**
+ * The native unsigned integral that is exactly bytes wide, or void where
+ * there is none. Counters of that size can be added to as a single integer.
+ */
+template <size_t bytes>
+struct wide_word
+{
+  using type = void;
+};
+
+template <>
+struct wide_word<sizeof(uint64_t)>
+{
+  using type = uint64_t;
+};
+
+#if defined(__SIZEOF_INT128__)
+template <>
+struct wide_word<sizeof(uint128_t)>
+{
+  using type = uint128_t;
+};
+#endif
+
+template <size_t bytes>
+using wide_word_t = typename wide_word<bytes>::type;
+
+/**
+ * Rotates word left by shift bits. std::rotl is constexpr and compiles to a
+ * single rotate instruction where the target has one.
+ */
+template <unsigned shift, std::unsigned_integral word_t>
+constexpr word_t rotate_left(word_t word) noexcept
+{
+  constexpr int digits = std::numeric_limits<word_t>::digits;
+  return std::rotl(word, static_cast<int>(shift % digits));
+}
+
 }  // namespace qtfy::random::utilities
 
 #endif
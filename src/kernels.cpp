@@ -0,0 +1,45 @@
+#include "qtfy/random.hpp"
+
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && \
+    defined(__linux__)
+// one clone per x86-64 micro architecture level, selected through an ifunc
+// resolver when the library is loaded.
+#define QTFY_KERNEL_CLONES \
+  __attribute__((target_clones("default", "arch=x86-64-v3", "arch=x86-64-v4")))
+#else
+#define QTFY_KERNEL_CLONES
+#endif
+
+namespace qtfy::random::kernels {
+
+// QTFY_RANDOM_LINK_KERNELS is defined here as in every consumer, so the
+// traits are the same in all translation units. trait_t::bijection_batch
+// forwards to this function, which therefore calls the header
+// implementation under its own name.
+template <class trait_t>
+QTFY_KERNEL_CLONES void bijection_batch(
+    std::span<const typename trait_t::counter_type> counters,
+    std::span<typename trait_t::counter_type> results,
+    typename trait_t::internal_key_type key) noexcept
+{
+  trait_t::bijection_batch_inline(counters, results, key);
+}
+
+#define QTFY_INSTANTIATE_KERNEL(trait_t)                     \
+  template void bijection_batch<trait_t>(                    \
+      std::span<const typename trait_t::counter_type>,       \
+      std::span<typename trait_t::counter_type>,             \
+      typename trait_t::internal_key_type) noexcept;
+
+QTFY_INSTANTIATE_KERNEL(threefry2x64_trait<20>)
+QTFY_INSTANTIATE_KERNEL(threefry2x32_trait<20>)
+QTFY_INSTANTIATE_KERNEL(threefry4x64_trait<20>)
+QTFY_INSTANTIATE_KERNEL(threefry4x32_trait<20>)
+QTFY_INSTANTIATE_KERNEL(philox2x64_trait<10>)
+QTFY_INSTANTIATE_KERNEL(philox2x32_trait<10>)
+QTFY_INSTANTIATE_KERNEL(philox4x64_trait<10>)
+QTFY_INSTANTIATE_KERNEL(philox4x32_trait<10>)
+
+#undef QTFY_INSTANTIATE_KERNEL
+
+}  // namespace qtfy::random::kernels
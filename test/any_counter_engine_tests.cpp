@@ -0,0 +1,157 @@
+#include <vector>
+
+#include "qtfy/random.hpp"
+#include "qtfy/random/any_counter_engine.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+static_assert(parse_engine_spec("philox4x32-10") ==
+              engine_spec{bijection_family::philox, 4U, 32U, 10U});
+static_assert(parse_engine_spec("threefry2x64") ==
+              engine_spec{bijection_family::threefry, 2U, 64U, 20U});
+static_assert(parse_engine_spec("philox2x64") ==
+              engine_spec{bijection_family::philox, 2U, 64U, 10U});
+static_assert(!parse_engine_spec(""));
+static_assert(!parse_engine_spec("philox"));
+static_assert(!parse_engine_spec("philox4x"));
+static_assert(!parse_engine_spec("philox4x32-"));
+static_assert(!parse_engine_spec("philox3x32-10"));
+static_assert(!parse_engine_spec("threefry4x16-20"));
+static_assert(!parse_engine_spec("threefry4x64-20 "));
+static_assert(!parse_engine_spec("aes4x32-10"));
+static_assert(!parse_engine_spec("philox4x32-99999999999"));
+
+// the engine built from a spec draws the values of the engine it names,
+// keyed with fold_in({}, seed), through every batch.
+template <class trait_t>
+void test_matches_engine(std::string_view spec)
+{
+  constexpr uint64_t seed = 0x0123456789ABCDEFU;
+  auto erased = make_any_counter_engine(spec, seed);
+  assert_are_equal(erased.has_value(), true);
+  counter_based_engine<trait_t, uint64_t> engine{
+      fold_in<trait_t>(typename trait_t::key_type{}, seed)};
+
+  for (size_t size : {0U, 1U, 3U, 17U, 512U, 1001U})
+  {
+    std::vector<uint64_t> actual(size);
+    std::vector<uint64_t> expected(size);
+    erased->fill(actual);
+    engine.generate(expected);
+    assert_are_equal(actual, expected);
+
+    std::vector<double> canonical_actual(size);
+    std::vector<double> canonical_expected(size);
+    erased->fill_canonical(canonical_actual);
+    engine.fill_canonical(std::span<double>{canonical_expected});
+    assert_are_equal(canonical_actual, canonical_expected);
+  }
+
+  erased->discard(12345U);
+  engine.discard(12345U);
+  std::vector<uint64_t> actual(7);
+  erased->fill(actual);
+  for (uint64_t value : actual)
+  {
+    assert_are_equal(value, engine());
+  }
+}
+
+void test_specs()
+{
+  test_matches_engine<philox2x32_trait<10>>("philox2x32");
+  test_matches_engine<philox4x32_trait<7>>("philox4x32-7");
+  test_matches_engine<philox2x64_trait<10>>("philox2x64-10");
+  test_matches_engine<philox4x64_trait<10>>("philox4x64");
+  test_matches_engine<threefry2x32_trait<13>>("threefry2x32-13");
+  test_matches_engine<threefry4x32_trait<12>>("threefry4x32-12");
+  test_matches_engine<threefry2x64_trait<20>>("threefry2x64");
+  test_matches_engine<threefry4x64_trait<20>>("threefry4x64-20");
+
+  const engine_spec spec{bijection_family::threefry, 4U, 64U, 13U};
+  assert_are_equal(to_string(spec), std::string{"threefry4x64-13"});
+  assert_are_equal(parse_engine_spec(to_string(spec)) == spec, true);
+  assert_are_equal(make_any_counter_engine(spec, 1U).has_value(), true);
+
+  // the rounds the factory builds can be chosen by the caller.
+  using philox_rounds = std::integer_sequence<unsigned, 6U>;
+  auto six = make_any_counter_engine<philox_rounds>("philox4x32-6", 1U);
+  assert_are_equal(six.has_value(), true);
+  assert_are_equal(
+      make_any_counter_engine<philox_rounds>("philox4x32-10", 1U).has_value(),
+      false);
+  counter_based_engine<philox4x32_trait<6>, uint64_t> engine{
+      fold_in<philox4x32_trait<6>>({}, 1U)};
+  std::vector<uint64_t> actual(9);
+  six->fill(actual);
+  for (uint64_t value : actual)
+  {
+    assert_are_equal(value, engine());
+  }
+}
+
+// rounds the factory is not built for and malformed specs build no engine.
+void test_unsupported_specs()
+{
+  for (std::string_view spec :
+       {"philox4x32-20", "threefry4x64-10", "philox4x32-0", "philox4x16",
+        "threefry"})
+  {
+    assert_are_equal(make_any_counter_engine(spec, 1U).has_value(), false);
+  }
+  assert_are_equal(
+      make_any_counter_engine(engine_spec{bijection_family::philox, 3U, 32U, 10U},
+                              1U)
+          .has_value(),
+      false);
+}
+
+// copies draw the same values independently of each other, and any engine
+// with 64 bit results can be erased.
+void test_copies_and_erased_engines()
+{
+  any_counter_engine engine{threefry4x64<uint64_t, 20, 16U>{{1U, 2U, 3U, 4U}}};
+  engine.discard(3U);
+  any_counter_engine copy = engine;
+  std::vector<uint64_t> first(100);
+  std::vector<uint64_t> second(100);
+  engine.fill(first);
+  copy.fill(second);
+  assert_are_equal(first, second);
+
+  copy = engine;
+  any_counter_engine moved = std::move(copy);
+  moved.fill(first);
+  engine.fill(second);
+  assert_are_equal(first, second);
+
+  threefry4x64<uint64_t, 20, 16U> expected{{1U, 2U, 3U, 4U}};
+  expected.discard(103U);
+  assert_are_equal(first.front(), expected());
+
+  // copies of a moved-from engine are moved-from as well, and can be
+  // assigned to.
+  any_counter_engine moved_from_copy = copy;
+  moved_from_copy = copy;
+  moved_from_copy = moved;
+  moved_from_copy.fill(first);
+  moved.fill(second);
+  assert_are_equal(first, second);
+
+  using trait_t = philox4x32_trait<10>;
+  any_counter_engine fixed{
+      static_key_counter_engine<trait_t, trait_t::key_type{5U, 6U}, uint64_t>{}};
+  philox4x32<uint64_t> runtime{{5U, 6U}};
+  fixed.fill(first);
+  runtime.generate(second);
+  assert_are_equal(first, second);
+}
+
+int main()
+{
+  test_specs();
+  test_unsupported_specs();
+  test_copies_and_erased_engines();
+  std::cout << "success";
+}
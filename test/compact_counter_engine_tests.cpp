@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+// the compact engine draws the sequence of counter_based_engine, value by
+// value, through generate and after discard.
+template <class trait_t, class result_t>
+void test_matches_engine()
+{
+  using compact_t = compact_counter_engine<trait_t, result_t>;
+  using engine_t = counter_based_engine<trait_t, result_t>;
+  const typename trait_t::key_type key{11U};
+  const typename trait_t::counter_type start{UINT32_MAX, 5U};
+
+  compact_t compact{key, start};
+  engine_t engine{key, start};
+  for (size_t i{}; i < 100U; ++i)
+  {
+    assert_are_equal(compact.at(i), engine.at(i));
+  }
+  for (size_t i{}; i < 37U; ++i)
+  {
+    assert_are_equal(compact(), engine());
+  }
+
+  for (size_t size : {0U, 1U, 3U, 17U, 64U, 200U, 1001U})
+  {
+    std::vector<result_t> actual(size);
+    std::vector<result_t> expected(size);
+    compact.generate(actual);
+    engine.generate(expected);
+    assert_are_equal(actual, expected);
+    assert_are_equal(compact(), engine());
+  }
+
+  for (unsigned long long steps : {0ULL, 1ULL, 2ULL, 7ULL, 1000ULL, 1ULL << 40U})
+  {
+    compact.discard(steps);
+    engine.discard(steps);
+    assert_are_equal(compact(), engine());
+  }
+}
+
+template <class trait_t>
+void test_trait()
+{
+  using word_t = typename trait_t::word_type;
+  test_matches_engine<trait_t, word_t>();
+  test_matches_engine<trait_t, uint8_t>();
+  if constexpr (sizeof(word_t) == 8U)
+  {
+    test_matches_engine<trait_t, uint32_t>();
+  }
+  else
+  {
+    test_matches_engine<trait_t, uint64_t>();
+  }
+}
+
+// the state is small, trivially copyable and assignable, so engines can be
+// kept, sorted and compacted in containers.
+void test_state()
+{
+  using compact_t = compact_counter_engine<philox4x32_trait<10>>;
+  static_assert(std::is_trivially_copyable_v<compact_t>);
+  static_assert(std::is_trivially_copy_assignable_v<compact_t>);
+  static_assert(2U * sizeof(compact_t) <= sizeof(philox4x32<>));
+  static_assert(sizeof(compact_t) <
+                sizeof(philox4x32_trait<10>::internal_key_type));
+  static_assert(std::is_trivially_copyable_v<
+                compact_counter_engine<threefry4x64_trait<20>>>);
+
+  std::vector<compact_t> engines{};
+  for (uint32_t i{}; i < 10U; ++i)
+  {
+    engines.emplace_back(compact_t::key_type{i % 3U, i});
+  }
+  std::sort(engines.begin(), engines.end(), [](auto& l, auto& r) {
+    return l.key()[0U] < r.key()[0U];
+  });
+  const compact_t copy = engines[4];
+  assert_are_equal(copy, engines[4]);
+  assert_are_equal(compact_t{copy}(), engines[4]());
+}
+
+void engine_is_constexpr()
+{
+  constexpr auto value = [] {
+    compact_counter_engine<threefry2x64_trait<20>> compact{{1U, 2U}};
+    compact.discard(3U);
+    return compact();
+  }();
+  static_assert(value == threefry2x64<>::draw_at({1U, 2U}, {}, 3U));
+}
+
+int main()
+{
+  test_trait<philox2x32_trait<10>>();
+  test_trait<philox4x32_trait<10>>();
+  test_trait<philox2x64_trait<10>>();
+  test_trait<philox4x64_trait<10>>();
+  test_trait<threefry2x32_trait<20>>();
+  test_trait<threefry4x32_trait<20>>();
+  test_trait<threefry2x64_trait<20>>();
+  test_trait<threefry4x64_trait<20>>();
+  test_state();
+  engine_is_constexpr();
+  std::cout << "success";
+}
@@ -87,6 +87,298 @@ void test_different_return_types()
   }
 }
 
+// an engine buffering several blocks must produce the same sequence as one
+// buffering a single block, including across discards.
+template <class trait_t, class result_t, size_t depth>
+void test_depth()
+{
+  using shallow_t = counter_based_engine<trait_t, result_t>;
+  using deep_t = counter_based_engine<trait_t, result_t, depth>;
+  const typename trait_t::key_type key{};
+  const typename trait_t::counter_type ctr{5U};
+  shallow_t shallow{key, ctr};
+  deep_t deep{key, ctr};
+  for (unsigned long long jump : {0U, 1U, 3U, 7U, 16U, 31U, 100U, 1000U})
+  {
+    for (int i{}; i < 50; ++i)
+    {
+      assert_are_equal(shallow(), deep());
+    }
+    shallow.discard(jump);
+    deep.discard(jump);
+  }
+}
+
+// discarding whole blocks must match discarding the same number of values,
+// and jumps beyond any integral must land where a fresh engine starts.
+template <class engine_t>
+void test_discard_blocks()
+{
+  using counter_t = typename engine_t::counter_type;
+  constexpr size_t block_size = typename engine_t::block_type{}.size();
+  for (size_t offset : {0U, 1U, 3U, 5U})
+  {
+    for (size_t blocks : {0U, 1U, 2U, 5U, 40U})
+    {
+      for (size_t intra_block : {0U, 1U, 3U, 9U})
+      {
+        engine_t by_steps{};
+        engine_t by_blocks{};
+        by_steps.discard(offset);
+        by_blocks.discard(offset);
+        by_steps.discard(blocks * block_size + intra_block);
+        by_blocks.discard(counter_t{} + blocks, intra_block);
+        for (int i{}; i < 20; ++i)
+        {
+          assert_are_equal(by_steps(), by_blocks());
+        }
+      }
+    }
+  }
+
+  const typename engine_t::key_type key{};
+  const counter_t start{3U};
+  const counter_t partition = counter_t{1U} << 80U;
+  for (size_t n : {1U, 2U, 7U})
+  {
+    engine_t jumped{key, start};
+    jumped.discard(partition * n, 2U);
+    engine_t expected{key, start + partition * n};
+    expected.discard(2U);
+    for (int i{}; i < 20; ++i)
+    {
+      assert_are_equal(jumped(), expected());
+    }
+  }
+}
+
+// random access must return what a discarded copy of the engine would draw,
+// and must not change the state of the engine.
+template <class engine_t>
+void test_random_access()
+{
+  using result_t = decltype(engine_t{}());
+  const std::vector<uint64_t> indices{0U, 1U, 2U, 3U, 7U, 8U, 31U, 32U, 33U,
+                                      100U, 1000U, 123456789U};
+  for (size_t offset : {0U, 1U, 3U, 4U, 9U})
+  {
+    engine_t engine{};
+    engine.discard(offset);
+    const engine_t reference = engine;
+
+    std::vector<result_t> gathered(indices.size());
+    engine.gather(indices, gathered);
+    for (size_t i{}; i < indices.size(); ++i)
+    {
+      engine_t expected = reference;
+      expected.discard(indices[i]);
+      const result_t value = expected();
+      assert_are_equal(engine.at(indices[i]), value);
+      assert_are_equal(gathered[i], value);
+    }
+
+    for (unsigned long long n : {0U, 1U, 2U, 5U, 17U, 4000U})
+    {
+      engine_t expected = reference;
+      for (unsigned long long i{}; i < n; ++i)
+      {
+        expected.next_canonical();
+      }
+      assert_are_equal(engine.next_canonical_at(n), expected.next_canonical());
+    }
+
+    // the engine itself has not moved.
+    engine_t unchanged = reference;
+    for (int i{}; i < 20; ++i)
+    {
+      assert_are_equal(engine(), unchanged());
+    }
+  }
+
+  const typename engine_t::key_type key{7U};
+  const typename engine_t::counter_type ctr{11U};
+  for (uint64_t n : {0U, 1U, 5U, 999U})
+  {
+    engine_t expected{key, ctr};
+    expected.discard(n);
+    assert_are_equal(engine_t::draw_at(key, ctr, n), expected());
+  }
+}
+
+// a substream starts where the stream id, shifted into the high bits of the
+// counter, points and shares the key of the engine it was created from.
+template <class engine_t, size_t stream_bits>
+void test_substream()
+{
+  using counter_t = typename engine_t::counter_type;
+  constexpr size_t counter_bits =
+      counter_t{}.size() *
+      std::numeric_limits<typename counter_t::value_type>::digits;
+  const typename engine_t::key_type key{3U};
+  engine_t root{key, counter_t{5U}};
+  root.discard(11U);
+
+  // only substreams hold a stream id.
+  static_assert(sizeof(engine_t) <
+                sizeof(root.template substream<stream_bits>(0U)));
+
+  for (uint64_t id : {0U, 1U, 2U, 1000U, (1U << 20U) - 1U})
+  {
+    auto stream = root.template substream<stream_bits>(id);
+    engine_t expected{key, (counter_t{} + id) << (counter_bits - stream_bits)};
+    for (int i{}; i < 20; ++i)
+    {
+      assert_are_equal(stream(), expected());
+    }
+
+    // the last buffer of a stream is still part of it.
+    constexpr size_t depth = typename engine_t::buffer_type{}.size() /
+                             typename engine_t::block_type{}.size();
+    auto last = root.template substream<stream_bits>(id);
+    counter_t to_last = counter_t{1U} << (counter_bits - stream_bits);
+    to_last -= depth;
+    last.discard(to_last, 0U);
+    engine_t expected_last{
+        key, ((counter_t{} + id) << (counter_bits - stream_bits)) + to_last};
+    assert_are_equal(last(), expected_last());
+  }
+}
+
+template <class engine_t>
+void test_generate()
+{
+  using result_t = decltype(engine_t{}());
+  for (size_t offset : {0U, 1U, 3U, 4U, 7U})
+  {
+    for (size_t size : {0U, 1U, 2U, 3U, 4U, 5U, 8U, 17U, 64U, 101U})
+    {
+      engine_t scalar{};
+      engine_t bulk{};
+      scalar.discard(offset);
+      bulk.discard(offset);
+
+      std::vector<result_t> expected(size);
+      for (auto& x : expected)
+      {
+        x = scalar();
+      }
+      std::vector<result_t> actual(size);
+      bulk.generate(actual);
+      assert_are_equal(expected, actual);
+
+      // the engines must continue identically after a bulk call.
+      for (int i{}; i < 10; ++i)
+      {
+        assert_are_equal(scalar(), bulk());
+      }
+    }
+  }
+}
+
+void test_generate_iterators()
+{
+  threefry2x32<> scalar{};
+  threefry2x32<> bulk{};
+  std::vector<uint32_t> expected(33);
+  for (auto& x : expected)
+  {
+    x = scalar();
+  }
+  std::vector<uint32_t> actual(33);
+  bulk.generate(actual.begin(), actual.end());
+  assert_are_equal(expected, actual);
+}
+
+template <class engine_t, class T,
+          unsigned bits = std::numeric_limits<T>::digits,
+          canonical_interval interval = canonical_interval::closed_open>
+void test_fill_canonical()
+{
+  for (size_t offset : {0U, 1U, 2U, 3U, 4U})
+  {
+    for (size_t size : {0U, 1U, 2U, 3U, 4U, 5U, 8U, 17U, 64U, 101U})
+    {
+      engine_t scalar{};
+      engine_t bulk{};
+      scalar.discard(offset);
+      bulk.discard(offset);
+
+      std::vector<T> expected(size);
+      for (auto& x : expected)
+      {
+        x = scalar.template next_canonical<T, bits, interval>();
+      }
+      std::vector<T> actual(size);
+      bulk.template fill_canonical<T, bits, interval>(actual);
+      assert_are_equal(expected, actual);
+
+      for (int i{}; i < 10; ++i)
+      {
+        assert_are_equal(scalar(), bulk());
+      }
+    }
+  }
+}
+
+template <uint32_t value>
+struct constant_trait
+{
+  using word_type = uint32_t;
+  using counter_type = counter<uint32_t, 4>;
+  using key_type = counter<uint32_t, 4>;
+  using internal_key_type = counter<uint32_t, 4>;
+
+  static constexpr internal_key_type set_key(key_type k) noexcept { return k; }
+
+  static constexpr counter_type bijection(
+      [[maybe_unused]] counter_type ctr,
+      [[maybe_unused]] internal_key_type key) noexcept
+  {
+    return {value, value, value, value};
+  }
+};
+
+void test_canonical_intervals()
+{
+  constexpr double epsilon = 0x1p-53;
+  auto test = [](auto engine, double expected_closed_open,
+                 double expected_open_closed, double expected_open_open) {
+    constexpr unsigned bits = 53;
+    using enum canonical_interval;
+    assert_are_equal(engine.template next_canonical<double, bits, closed_open>(),
+                     expected_closed_open);
+    assert_are_equal(engine.template next_canonical<double, bits, open_closed>(),
+                     expected_open_closed);
+    assert_are_equal(engine.template next_canonical<double, bits, open_open>(),
+                     expected_open_open);
+  };
+
+  test(counter_based_engine<constant_trait<0U>>{}, 0.0, epsilon, epsilon);
+  test(counter_based_engine<constant_trait<UINT32_MAX>>{}, 1.0 - epsilon, 1.0,
+       1.0 - epsilon);
+}
+
+void test_canonical_matches_scalbn()
+{
+  threefry4x64<> engine{};
+  threefry4x64<> reference{};
+  for (int i{}; i < 100; ++i)
+  {
+    const auto expected =
+        std::scalbn(static_cast<double>(reference() >> 11U), -53);
+    assert_are_equal(engine.next_canonical(), expected);
+  }
+}
+
+void next_canonical_is_constexpr()
+{
+  constexpr double x = [] {
+    philox4x32<> engine{};
+    return engine.next_canonical<double, 53, canonical_interval::open_open>();
+  }();
+  static_assert(x > 0.0 && x < 1.0);
+}
+
 int main()
 {
   test_mock_trait();
@@ -94,5 +386,43 @@ int main()
   test_call_operator();
   test_discard();
   test_different_return_types();
+  test_discard_blocks<philox4x64<>>();
+  test_discard_blocks<philox4x32<uint64_t, 10, 4>>();
+  test_discard_blocks<threefry4x64<uint8_t, 20, 3>>();
+  test_discard_blocks<counter_based_engine<mock_trait>>();
+  test_random_access<philox4x32<>>();
+  test_random_access<philox2x64<uint8_t, 10, 3>>();
+  test_random_access<threefry4x64<uint32_t, 20, 4>>();
+  test_random_access<counter_based_engine<mock_trait>>();
+  test_substream<philox4x32<>, 20U>();
+  test_substream<threefry4x64<uint32_t, 20, 4>, 64U>();
+  test_substream<philox2x32<>, 20U>();
+  test_generate<counter_based_engine<mock_trait>>();
+  test_generate<threefry4x64<uint32_t>>();
+  test_generate<philox2x64<>>();
+  test_generate<philox4x32<uint64_t>>();
+  test_generate<philox4x32<uint32_t, 10, 4>>();
+  test_generate<threefry2x64<uint64_t, 20, 3>>();
+  test_generate_iterators();
+  test_fill_canonical<philox4x32<>, double>();
+  test_fill_canonical<philox4x32<>, float>();
+  test_fill_canonical<philox2x32<>, double>();
+  test_fill_canonical<threefry4x64<>, double>();
+  test_fill_canonical<threefry4x64<>, float>();
+  test_fill_canonical<threefry4x64<uint32_t>, float>();
+  test_fill_canonical<threefry4x64<uint8_t>, double>();
+  test_fill_canonical<threefry2x64<uint16_t>, double, 32>();
+  test_fill_canonical<philox4x32<>, double, 53, canonical_interval::open_closed>();
+  test_fill_canonical<philox4x64<>, float, 24, canonical_interval::open_open>();
+  test_fill_canonical<philox4x32<uint32_t, 10, 4>, double>();
+  test_fill_canonical<threefry4x64<uint64_t, 20, 5>, float>();
+  test_fill_canonical<threefry2x64<uint16_t, 20, 3>, double, 32>();
+  test_depth<philox4x32_trait<10>, uint32_t, 4>();
+  test_depth<philox2x64_trait<10>, uint8_t, 7>();
+  test_depth<threefry4x64_trait<20>, uint64_t, 16>();
+  test_depth<mock_trait, uint32_t, 2>();
+  test_canonical_intervals();
+  test_canonical_matches_scalbn();
+  next_canonical_is_constexpr();
   std::cout << "success";
 }
\ No newline at end of file
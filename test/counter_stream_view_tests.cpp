@@ -0,0 +1,101 @@
+#include <algorithm>
+#include <vector>
+
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+using stream_t = counter_stream_view<philox4x32_trait<10>>;
+using canonical_t = canonical_view<double, philox4x32_trait<10>>;
+
+static_assert(std::random_access_iterator<stream_t::iterator>);
+static_assert(std::ranges::random_access_range<stream_t>);
+static_assert(std::ranges::view<stream_t>);
+static_assert(std::random_access_iterator<canonical_t::iterator>);
+static_assert(std::ranges::random_access_range<canonical_t>);
+static_assert(std::ranges::view<canonical_t>);
+static_assert(
+    std::same_as<std::iterator_traits<stream_t::iterator>::iterator_category,
+                 std::input_iterator_tag>);
+
+template <class trait_t, class result_t>
+void test_stream_matches_engine()
+{
+  const typename trait_t::key_type key{3U};
+  const typename trait_t::counter_type ctr{9U};
+  counter_stream_view<trait_t, result_t> stream{key, ctr};
+  counter_based_engine<trait_t, result_t> engine{key, ctr};
+
+  std::vector<result_t> expected(100);
+  engine.generate(expected);
+  std::vector<result_t> actual(100);
+  std::ranges::copy(stream | std::views::take(100), actual.begin());
+  assert_are_equal(expected, actual);
+
+  const auto first = stream.begin();
+  for (std::ptrdiff_t i : {0, 1, 5, 17, 99})
+  {
+    const auto value = expected[static_cast<size_t>(i)];
+    assert_are_equal(first[i], value);
+    assert_are_equal(*(first + i), value);
+    assert_are_equal(*(i + first), value);
+    assert_are_equal(*((first + 99) - (99 - i)), value);
+    assert_are_equal((first + i) - first, i);
+  }
+}
+
+// a stream processed in independent chunks must equal the sequential stream.
+void test_chunked_transform()
+{
+  stream_t stream{{1U, 2U}};
+  constexpr std::ptrdiff_t size = 1000;
+  auto twice = [](uint32_t x) { return uint64_t{x} * 2U; };
+
+  std::vector<uint64_t> expected(size);
+  std::transform(stream.begin(), stream.begin() + size, expected.begin(),
+                 twice);
+
+  std::vector<uint64_t> actual(size);
+  for (std::ptrdiff_t chunk : {600, 0, 900, 300})
+  {
+    const std::ptrdiff_t last = std::min(chunk + 300, size);
+    std::transform(stream.begin() + chunk, stream.begin() + last,
+                   actual.begin() + chunk, twice);
+  }
+  assert_are_equal(expected, actual);
+}
+
+template <class trait_t, class result_t, class T, unsigned bits,
+          canonical_interval interval>
+void test_canonical_matches_engine()
+{
+  const typename trait_t::key_type key{5U};
+  const counter_stream_view<trait_t, result_t> stream{key};
+  const auto canonical = stream.template canonical<T, bits, interval>();
+  counter_based_engine<trait_t, result_t> engine{key};
+  for (std::ptrdiff_t i{}; i < 50; ++i)
+  {
+    assert_are_equal(canonical[i],
+                     engine.template next_canonical<T, bits, interval>());
+  }
+
+  // the iterator holds the key and counter, so it outlives the view.
+  const auto first = stream.template canonical<T, bits, interval>().begin();
+  assert_are_equal(first[7], canonical[7]);
+}
+
+int main()
+{
+  test_stream_matches_engine<philox4x32_trait<10>, uint32_t>();
+  test_stream_matches_engine<threefry2x64_trait<20>, uint8_t>();
+  test_stream_matches_engine<threefry4x64_trait<20>, uint64_t>();
+  test_chunked_transform();
+  test_canonical_matches_engine<philox4x32_trait<10>, uint32_t, double, 53,
+                                canonical_interval::closed_open>();
+  test_canonical_matches_engine<threefry2x64_trait<20>, uint16_t, float, 24,
+                                canonical_interval::open_open>();
+  test_canonical_matches_engine<philox4x64_trait<10>, uint64_t, double, 32,
+                                canonical_interval::open_closed>();
+  std::cout << "success";
+}
@@ -89,6 +89,160 @@ void test_reinterpret()
   assert_are_equal(expected32, arr32);
 }
 
+// the runtime fast paths must agree with the word by word loops that are used
+// during constant evaluation.
+template <class ctr_t, ctr_t input, auto operand>
+void assert_runtime_matches_constexpr()
+{
+  constexpr ctr_t expected_sum = [] {
+    auto x = input;
+    return x += operand;
+  }();
+  constexpr ctr_t expected_difference = [] {
+    auto x = input;
+    return x -= operand;
+  }();
+  constexpr ctr_t expected_incremented = [] {
+    auto x = input;
+    return ++x;
+  }();
+  constexpr ctr_t expected_decremented = [] {
+    auto x = input;
+    return --x;
+  }();
+
+  auto actual = input;
+  assert_are_equal(actual += operand, expected_sum);
+  actual = input;
+  assert_are_equal(actual -= operand, expected_difference);
+  actual = input;
+  assert_are_equal(++actual, expected_incremented);
+  actual = input;
+  assert_are_equal(--actual, expected_decremented);
+}
+
+void test_runtime_matches_constexpr()
+{
+  constexpr uint32_t max32 = std::numeric_limits<uint32_t>::max();
+  constexpr uint64_t max64 = std::numeric_limits<uint64_t>::max();
+
+  using ctr2x32 = counter<uint32_t, 2>;
+  assert_runtime_matches_constexpr<ctr2x32, ctr2x32{max32, 1U}, 2U>();
+  assert_runtime_matches_constexpr<ctr2x32, ctr2x32{0U, 0U}, max64>();
+
+  using ctr4x32 = counter<uint32_t, 4>;
+  assert_runtime_matches_constexpr<ctr4x32, ctr4x32{max32, max32, max32, 7U},
+                                   1U>();
+  assert_runtime_matches_constexpr<ctr4x32, ctr4x32{0U, 0U, 0U, 0U}, 3U>();
+  assert_runtime_matches_constexpr<ctr4x32, ctr4x32{5U, max32, 0U, 1U},
+                                   max64>();
+
+  using ctr2x64 = counter<uint64_t, 2>;
+  assert_runtime_matches_constexpr<ctr2x64, ctr2x64{max64, 1U}, 1U>();
+  assert_runtime_matches_constexpr<ctr2x64, ctr2x64{0U, 0U}, max64>();
+  assert_runtime_matches_constexpr<ctr2x64, ctr2x64{max64, max64}, max32>();
+
+  using ctr3x32 = counter<uint32_t, 3>;
+  assert_runtime_matches_constexpr<ctr3x32, ctr3x32{max32, max32, 1U},
+                                   max64>();
+  assert_runtime_matches_constexpr<ctr3x32, ctr3x32{0U, 0U, 0U}, 1U>();
+
+  using ctr4x64 = counter<uint64_t, 4>;
+  assert_runtime_matches_constexpr<ctr4x64,
+                                   ctr4x64{max64, max64, max64, 2U}, 1U>();
+  assert_runtime_matches_constexpr<ctr4x64, ctr4x64{0U, 0U, 0U, 0U}, max64>();
+  assert_runtime_matches_constexpr<ctr4x64, ctr4x64{1U, 0U, max64, 0U},
+                                   uint8_t{2U}>();
+
+  using ctr4x8 = counter<uint8_t, 4>;
+  assert_runtime_matches_constexpr<ctr4x8, ctr4x8{255U, 255U, 0U, 1U},
+                                   uint64_t{0x1'0000'0101U}>();
+}
+
+void test_counter_arithmetic()
+{
+  constexpr uint32_t max32 = std::numeric_limits<uint32_t>::max();
+  using ctr3 = counter<uint32_t, 3>;
+
+  static_assert(ctr3{max32, 1U, 0U} + ctr3{1U, max32, 2U} == ctr3{0U, 1U, 3U});
+  static_assert(ctr3{0U, 1U, 3U} - ctr3{1U, max32, 2U} == ctr3{max32, 1U, 0U});
+  static_assert(ctr3{0U, 0U, 0U} - ctr3{1U, 0U, 0U} ==
+                ctr3{max32, max32, max32});
+  assert_are_equal(ctr3{max32, 1U, 0U} + ctr3{1U, max32, 2U},
+                   ctr3{0U, 1U, 3U});
+  assert_are_equal(ctr3{0U, 1U, 3U} - ctr3{1U, max32, 2U},
+                   ctr3{max32, 1U, 0U});
+
+  using ctr2x64 = counter<uint64_t, 2>;
+  constexpr uint64_t max64 = std::numeric_limits<uint64_t>::max();
+  assert_are_equal(ctr2x64{max64, 1U} + ctr2x64{1U, 2U}, ctr2x64{0U, 4U});
+  assert_are_equal(ctr2x64{0U, 4U} - ctr2x64{1U, 2U}, ctr2x64{max64, 1U});
+}
+
+void test_ordering()
+{
+  using ctr3 = counter<uint32_t, 3>;
+  static_assert(ctr3{5U, 0U, 1U} > ctr3{0U, 7U, 0U});
+  static_assert(ctr3{5U, 7U, 1U} < ctr3{0U, 8U, 1U});
+  static_assert(ctr3{5U, 7U, 1U} <= ctr3{5U, 7U, 1U});
+  static_assert((ctr3{5U, 7U, 1U} <=> ctr3{5U, 7U, 1U}) == 0);
+  assert_are_equal(ctr3{0U, 0U, 2U} > ctr3{9U, 9U, 1U}, true);
+  assert_are_equal(ctr3{9U, 9U, 1U} < ctr3{0U, 0U, 2U}, true);
+}
+
+template <class ctr_t, ctr_t input, auto multiplier>
+void assert_multiply_matches_constexpr()
+{
+  constexpr ctr_t expected = input * multiplier;
+  assert_are_equal(input * multiplier, expected);
+}
+
+void test_multiply()
+{
+  constexpr uint32_t max32 = std::numeric_limits<uint32_t>::max();
+  constexpr uint64_t max64 = std::numeric_limits<uint64_t>::max();
+
+  using ctr3 = counter<uint32_t, 3>;
+  static_assert(ctr3{max32, 0U, 0U} * uint32_t{2U} == ctr3{max32 - 1U, 1U, 0U});
+  static_assert(ctr3{max32, max32, 0U} * max32 ==
+                ctr3{1U, max32, max32 - 1U});
+  // the multiplier is wider than a word.
+  static_assert(ctr3{1U, 1U, 0U} * (uint64_t{1U} << 32U) == ctr3{0U, 1U, 1U});
+  static_assert(ctr3{2U, 0U, 0U} * max64 == ctr3{max32 - 1U, max32, 1U});
+  static_assert(uint32_t{3U} * ctr3{1U, 2U, 3U} == ctr3{3U, 6U, 9U});
+  assert_are_equal(ctr3{max32, max32, 0U} * max32,
+                   ctr3{1U, max32, max32 - 1U});
+
+  using ctr4x64 = counter<uint64_t, 4>;
+  assert_multiply_matches_constexpr<ctr4x64, ctr4x64{max64, max64, 3U, 0U},
+                                    max64>();
+  using ctr2x64 = counter<uint64_t, 2>;
+  assert_multiply_matches_constexpr<ctr2x64, ctr2x64{max64, 5U}, max64>();
+  using ctr4x32 = counter<uint32_t, 4>;
+  assert_multiply_matches_constexpr<ctr4x32, ctr4x32{max32, 5U, 0U, 1U},
+                                    max64>();
+  using ctr2x16 = counter<uint16_t, 2>;
+  assert_multiply_matches_constexpr<ctr2x16, ctr2x16{0xFFFFU, 0x1234U},
+                                    uint64_t{0x1'0003U}>();
+}
+
+void test_shift()
+{
+  using ctr3 = counter<uint32_t, 3>;
+  static_assert((ctr3{1U, 0U, 0U} << 0U) == ctr3{1U, 0U, 0U});
+  static_assert((ctr3{1U, 0U, 0U} << 32U) == ctr3{0U, 1U, 0U});
+  static_assert((ctr3{1U, 0U, 0U} << 80U) == ctr3{0U, 0U, 0x10000U});
+  static_assert((ctr3{0x80000001U, 1U, 0U} << 1U) == ctr3{2U, 3U, 0U});
+  static_assert((ctr3{1U, 2U, 3U} << 96U) == ctr3{0U, 0U, 0U});
+  static_assert((ctr3{1U, 2U, 3U} << 1000U) == ctr3{0U, 0U, 0U});
+  static_assert((ctr3{0U, 0U, 0x10000U} >> 80U) == ctr3{1U, 0U, 0U});
+  static_assert((ctr3{2U, 3U, 0U} >> 1U) == ctr3{0x80000001U, 1U, 0U});
+  static_assert((ctr3{1U, 2U, 3U} >> 32U) == ctr3{2U, 3U, 0U});
+  static_assert((ctr3{1U, 2U, 3U} >> 96U) == ctr3{0U, 0U, 0U});
+  assert_are_equal(ctr3{0x80000001U, 1U, 0U} << 33U, ctr3{0U, 2U, 3U});
+  assert_are_equal(ctr3{0U, 2U, 3U} >> 33U, ctr3{0x80000001U, 1U, 0U});
+}
+
 int main()
 {
   test_increment_decrement();
@@ -97,5 +251,10 @@ int main()
   test_subtract_small();
   test_subtract_large();
   test_reinterpret();
+  test_runtime_matches_constexpr();
+  test_counter_arithmetic();
+  test_ordering();
+  test_multiply();
+  test_shift();
   std::cout << "success";
 }
\ No newline at end of file
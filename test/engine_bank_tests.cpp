@@ -0,0 +1,92 @@
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+// every engine sits in its own slot, so no two share a cache line.
+template <class engine_t>
+void test_slots_are_isolated()
+{
+  engine_bank<engine_t> bank{{1U}, 5U};
+  assert_are_equal(bank.size(), 5U);
+  for (size_t i{}; i < bank.size(); ++i)
+  {
+    const auto address = reinterpret_cast<std::uintptr_t>(&bank[i]);
+    assert_are_equal(address % destructive_interference_size, 0U);
+  }
+  static_assert(alignof(engine_t) <= destructive_interference_size);
+}
+
+// the engine of worker n is derived from the key and n alone.
+template <class engine_t>
+void test_engines_are_derived_from_worker()
+{
+  using trait_t = typename engine_t::trait_type;
+  const typename trait_t::key_type key{3U};
+  engine_bank<engine_t> small{key, 2U};
+  engine_bank<engine_t> large{key, 7U};
+  for (size_t n{}; n < small.size(); ++n)
+  {
+    std::array<typename trait_t::key_type, 1U> child{};
+    split<trait_t>(key, child, n);
+    engine_t expected{child[0U]};
+    for (size_t i{}; i < 20U; ++i)
+    {
+      const auto value = expected();
+      assert_are_equal(small[n](), value);
+      assert_are_equal(large[n](), value);
+    }
+  }
+  if (large[2]() == large[3]())
+  {
+    throw std::exception{};
+  }
+}
+
+// worker n draws the same values whichever thread runs it.
+void test_local_follows_worker()
+{
+  using engine_t = threefry4x64<>;
+  constexpr size_t workers = 4U;
+  constexpr size_t draws = 100U;
+
+  auto run = [](const std::vector<size_t>& assignment) {
+    engine_bank<engine_t> bank{{1U, 2U, 3U, 4U}, workers};
+    std::vector<std::vector<uint64_t>> values(workers);
+    std::vector<std::thread> threads{};
+    for (size_t t{}; t < workers; ++t)
+    {
+      threads.emplace_back([&, worker = assignment[t]] {
+        bind_worker(worker);
+        assert_are_equal(bound_worker(), worker);
+        for (size_t i{}; i < draws; ++i)
+        {
+          values[worker].push_back(bank.local()());
+        }
+      });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+    return values;
+  };
+
+  assert_are_equal(run({0U, 1U, 2U, 3U}), run({3U, 1U, 0U, 2U}));
+  assert_are_equal(bound_worker(), unbound_worker);
+}
+
+int main()
+{
+  test_slots_are_isolated<threefry4x64<>>();
+  test_slots_are_isolated<philox2x32<>>();
+  test_slots_are_isolated<philox4x64<uint64_t, 10, 4>>();
+  test_engines_are_derived_from_worker<threefry4x64<>>();
+  test_engines_are_derived_from_worker<philox4x32<>>();
+  test_local_follows_worker();
+  std::cout << "success";
+}
@@ -0,0 +1,52 @@
+#include <iostream>
+#include <vector>
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+// checks that the engine takes its batch bijection from qtfy_random_kernels
+// and that the bulk output is unchanged by doing so.
+template <class engine_t, class trait_t>
+void test_engine()
+{
+  static_assert(kernels::is_compiled<trait_t>);
+  using result_t = decltype(engine_t{}());
+
+  engine_t scalar{{}, {}};
+  engine_t bulk{{}, {}};
+  std::vector<result_t> expected(1001);
+  for (auto& x : expected)
+  {
+    x = scalar();
+  }
+  std::vector<result_t> actual(expected.size());
+  bulk.generate(actual);
+  assert_are_equal(expected, actual);
+
+  using counter_t = typename trait_t::counter_type;
+  std::vector<counter_t> input{};
+  for (auto ctr :
+       counters<typename trait_t::word_type, counter_t{}.size()>(97))
+  {
+    input.push_back(ctr);
+  }
+  const auto key = trait_t::set_key({});
+  std::vector<counter_t> results(input.size());
+  trait_t::bijection_batch(input, results, key);
+  assert_are_equal(expected_bijections<trait_t>(input, key), results);
+}
+
+int main()
+{
+  test_engine<threefry2x64<>, threefry2x64_trait<20>>();
+  test_engine<threefry2x32<>, threefry2x32_trait<20>>();
+  test_engine<threefry4x64<>, threefry4x64_trait<20>>();
+  test_engine<threefry4x32<>, threefry4x32_trait<20>>();
+  test_engine<philox2x64<>, philox2x64_trait<10>>();
+  test_engine<philox2x32<>, philox2x32_trait<10>>();
+  test_engine<philox4x64<>, philox4x64_trait<10>>();
+  test_engine<philox4x32<>, philox4x32_trait<10>>();
+  static_assert(!kernels::is_compiled<philox4x32_trait<7>>);
+  std::cout << "success";
+}
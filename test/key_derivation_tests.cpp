@@ -0,0 +1,151 @@
+#include <algorithm>
+#include <vector>
+
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+template <class trait_t>
+void test_fold_in_uses_bijection()
+{
+  using key_type = typename trait_t::key_type;
+  using counter_t = typename trait_t::counter_type;
+  const key_type parent{7U};
+  for (uint64_t data : {0U, 1U, 2U, 1000U})
+  {
+    const auto block =
+        trait_t::bijection(counter_t{} + data, trait_t::set_key(parent));
+    const key_type child = fold_in<trait_t>(parent, data);
+    for (size_t i{}; i < child.size(); ++i)
+    {
+      assert_are_equal(child[i], block[i]);
+    }
+  }
+}
+
+// child i of split is the block of counter i with the highest bit set.
+template <class trait_t>
+void test_split_uses_bijection()
+{
+  using key_type = typename trait_t::key_type;
+  using counter_t = typename trait_t::counter_type;
+  using word_t = typename trait_t::word_type;
+  const key_type parent{7U};
+  const auto children = split<trait_t>(parent, 3U);
+  for (uint64_t i{}; i < children.size(); ++i)
+  {
+    counter_t ctr = counter_t{} + i;
+    ctr.back() |= word_t{1U} << (std::numeric_limits<word_t>::digits - 1);
+    const auto block = trait_t::bijection(ctr, trait_t::set_key(parent));
+    for (size_t j{}; j < parent.size(); ++j)
+    {
+      assert_are_equal(children[i][j], block[j]);
+    }
+  }
+}
+
+// split and fold_in never derive the same child from the same parent and
+// index.
+template <class trait_t>
+void test_split_differs_from_fold_in()
+{
+  using key_type = typename trait_t::key_type;
+  const key_type parent{3U};
+  const auto children = split<trait_t>(parent, 100U);
+  for (size_t i{}; i < children.size(); ++i)
+  {
+    assert_are_equal(children[i] == fold_in<trait_t>(parent, i), false);
+  }
+}
+
+// the batched forms must match their lazy forms, whatever the number of
+// children.
+template <class trait_t>
+void test_batches_match_lazy_forms()
+{
+  using key_type = typename trait_t::key_type;
+  const key_type parent{3U};
+  for (size_t n : {0U, 1U, 5U, 63U, 64U, 65U, 200U})
+  {
+    const auto children = split<trait_t>(parent, n);
+    assert_are_equal(children.size(), n);
+    for (size_t i{}; i < n; ++i)
+    {
+      std::array<key_type, 1U> child{};
+      split<trait_t>(parent, child, i);
+      assert_are_equal(children[i], child[0U]);
+    }
+
+    std::vector<key_type> offset(n);
+    split<trait_t>(parent, offset, 1000U);
+    const auto all = split<trait_t>(parent, 1000U + n);
+    std::vector<uint64_t> data(n);
+    for (size_t i{}; i < n; ++i)
+    {
+      data[i] = (i * 7919U) % 101U;
+    }
+    std::vector<key_type> folded(n);
+    fold_in<trait_t>(parent, data, folded);
+    for (size_t i{}; i < n; ++i)
+    {
+      assert_are_equal(offset[i], all[1000U + i]);
+      assert_are_equal(folded[i], fold_in<trait_t>(parent, data[i]));
+    }
+  }
+}
+
+// children of one parent, and children of different parents, are distinct.
+template <class trait_t>
+void test_children_are_distinct()
+{
+  using key_type = typename trait_t::key_type;
+  std::vector<key_type> keys = split<trait_t>(key_type{}, 500U);
+  const auto grandchildren = split<trait_t>(keys[1U], 500U);
+  keys.insert(keys.end(), grandchildren.begin(), grandchildren.end());
+  keys.push_back(key_type{});
+  auto less = [](const key_type& a, const key_type& b) { return a < b; };
+  std::sort(keys.begin(), keys.end(), less);
+  assert_are_equal(std::adjacent_find(keys.begin(), keys.end()), keys.end());
+}
+
+template <class trait_t>
+void test_trait()
+{
+  test_fold_in_uses_bijection<trait_t>();
+  test_split_uses_bijection<trait_t>();
+  test_split_differs_from_fold_in<trait_t>();
+  test_batches_match_lazy_forms<trait_t>();
+  test_children_are_distinct<trait_t>();
+}
+
+void derivation_is_constexpr()
+{
+  using trait_t = philox4x32_trait<10>;
+  constexpr auto child = [] {
+    std::array<trait_t::key_type, 1> result{};
+    split<trait_t>({1U, 2U}, result, 3U);
+    return result;
+  }();
+  constexpr auto children = [] {
+    std::array<trait_t::key_type, 4> result{};
+    split<trait_t>({1U, 2U}, result);
+    return result;
+  }();
+  static_assert(children[3U] == child[0U]);
+  static_assert(children[3U] != fold_in<trait_t>({1U, 2U}, 3U));
+}
+
+int main()
+{
+  test_trait<philox2x32_trait<10>>();
+  test_trait<philox4x32_trait<10>>();
+  test_trait<philox2x64_trait<10>>();
+  test_trait<philox4x64_trait<10>>();
+  test_trait<threefry2x32_trait<20>>();
+  test_trait<threefry4x32_trait<20>>();
+  test_trait<threefry2x64_trait<20>>();
+  test_trait<threefry4x64_trait<20>>();
+  derivation_is_constexpr();
+  std::cout << "success";
+}
@@ -13,9 +13,19 @@ struct test_case
   counter<word_t, words> expected;
 };
 
+template <class word_t, size_t words, unsigned rounds>
+using trait_for = std::conditional_t<
+    words == 2U,
+    std::conditional_t<std::is_same_v<word_t, uint32_t>,
+                       philox2x32_trait<rounds>, philox2x64_trait<rounds>>,
+    std::conditional_t<std::is_same_v<word_t, uint32_t>,
+                       philox4x32_trait<rounds>, philox4x64_trait<rounds>>>;
+
 template <class word_t, size_t words, unsigned rounds>
 auto test(std::vector<test_case<word_t, words>> cases)
 {
+  using trait_t = trait_for<word_t, words, rounds>;
+  using kernel_t = simd::philox_kernel<trait_t>;
   for (auto x : cases)
   {
     auto bijection = philox_factory<word_t, words, rounds>(x.key);
@@ -24,6 +34,18 @@ auto test(std::vector<test_case<word_t, words>> cases)
     {
       throw std::exception{};
     }
+
+    // enough copies to fill every lane of the widest kernel twice, plus a
+    // remainder for the scalar tail.
+    const std::vector<counter<word_t, words>> input(37, x.ctr);
+    std::vector<counter<word_t, words>> results(input.size());
+    trait_t::bijection_batch(input, results, trait_t::set_key(x.key));
+    for (auto result : results)
+    {
+      assert_are_equal(result, x.expected);
+    }
+    assert_batch_matches_bijection<trait_t, kernel_t>(input,
+                                                      trait_t::set_key(x.key));
   }
 }
 
@@ -142,17 +164,75 @@ void compare_runtime_and_compile_time_key()
   test<uint32_t, 2, 7, {2}>();
 }
 
+template <class trait_t>
+void test_batch(typename trait_t::key_type key)
+{
+  using kernel_t = simd::philox_kernel<trait_t>;
+  using counter_t = typename trait_t::counter_type;
+  for (size_t size : {0U, 1U, 7U, 8U, 16U, 33U, 100U})
+  {
+    std::vector<counter_t> input{};
+    for (auto ctr : counters<typename trait_t::word_type, counter_t{}.size()>(size))
+    {
+      input.push_back(ctr);
+    }
+    assert_batch_matches_bijection<trait_t, kernel_t>(input,
+                                                      trait_t::set_key(key));
+  }
+}
+
+void test_batch_random_counters()
+{
+  test_batch<philox4x32_trait<10>>({0x243f6a88, 0x85a308d3});
+  test_batch<philox2x32_trait<10>>({0x13198a2e});
+  test_batch<philox4x64_trait<10>>({0x452821e638d01377, 0xbe5466cf34e90c6c});
+  test_batch<philox2x64_trait<10>>({0xa4093822299f31d0});
+  test_batch<philox4x32_trait<7>>({UINT32_MAX, UINT32_MAX});
+  test_batch<philox4x64_trait<16>>({UINT64_MAX, 0});
+}
+
+template <class trait_t>
+void test_keys(typename trait_t::counter_type ctr)
+{
+  using kernel_t = simd::philox_kernel<trait_t>;
+  using key_type = typename trait_t::key_type;
+  for (size_t size : {0U, 1U, 7U, 8U, 16U, 33U, 100U})
+  {
+    std::vector<key_type> keys{};
+    for (auto key : counters<typename trait_t::word_type, key_type{}.size()>(size))
+    {
+      keys.push_back(key);
+    }
+    assert_keys_match_bijection<trait_t, kernel_t>(ctr, keys);
+  }
+}
+
+void test_keys_random_keys()
+{
+  test_keys<philox4x32_trait<10>>({0x243f6a88, 0x85a308d3, 1, 2});
+  test_keys<philox2x32_trait<10>>({0x13198a2e, 3});
+  test_keys<philox4x64_trait<10>>({0x452821e638d01377, 0xbe5466cf34e90c6c, 4, 5});
+  test_keys<philox2x64_trait<10>>({0xa4093822299f31d0, 6});
+  test_keys<philox4x32_trait<7>>({UINT32_MAX, UINT32_MAX, 0, 1});
+  test_keys<philox4x64_trait<16>>({UINT64_MAX, 0, 2, 3});
+}
+
 void bijection_is_constexpr()
 {
   constexpr auto bij = philox_factory<uint64_t, 4, 16>({});
   constexpr auto x = bij({});
   using t = std::array<int, x[0]>;
+  using trait_t = philox4x64_trait<16>;
+  constexpr auto y = trait_t::bijection_n<2U>({}, trait_t::set_key({}));
+  static_assert(y[0] == trait_t::bijection({}, trait_t::set_key({})));
 }
 
 int main()
 {
   test_runtime_key();
   compare_runtime_and_compile_time_key();
+  test_batch_random_counters();
+  test_keys_random_keys();
   bijection_is_constexpr();
   std::cout << "success";
 }
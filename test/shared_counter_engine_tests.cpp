@@ -0,0 +1,157 @@
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+// block b of the shared stream holds the values at [b * block_size,
+// (b + 1) * block_size) of the sequential engine.
+template <class trait_t, class result_t>
+void test_blocks_match_engine(typename trait_t::counter_type counter)
+{
+  using shared_t = shared_counter_engine<trait_t, result_t>;
+  constexpr size_t block_size = shared_t::block_size;
+  const typename trait_t::key_type key{5U};
+  shared_t shared{key, counter};
+
+  for (uint64_t blocks : {1U, 3U, 16U, 17U, 40U})
+  {
+    const auto range = shared.reserve(blocks);
+    assert_are_equal(range.count, blocks);
+    assert_are_equal(range.first_counter, counter + range.first_block);
+    std::vector<result_t> values(blocks * block_size);
+    shared.fill(range, values);
+    for (size_t i{}; i < values.size(); ++i)
+    {
+      assert_are_equal(values[i],
+                       shared_t::engine_type::draw_at(
+                           key, counter, range.first_block * block_size + i));
+    }
+  }
+  assert_are_equal(shared.reserved(), 77U);
+}
+
+// the consumer draws the values of its reservations in order, whether it is
+// called value by value or through generate.
+template <class trait_t>
+void test_consumer()
+{
+  using result_t = typename trait_t::word_type;
+  using shared_t = shared_counter_engine<trait_t, result_t>;
+  const typename trait_t::key_type key{9U};
+  shared_t shared{key};
+  auto first = shared.make_consumer(3U, true);
+  auto second = shared.make_consumer(5U, true);
+
+  std::vector<result_t> values(100);
+  for (auto& value : values)
+  {
+    value = first();
+  }
+  std::vector<result_t> generated(123);
+  second.generate(std::span<result_t>{generated.begin(), 40U});
+  second.generate(std::span<result_t>{generated.begin() + 40, 83U});
+
+  auto check = [&](const auto& consumer, const std::vector<result_t>& drawn) {
+    size_t i{};
+    for (const auto& range : consumer.reservations())
+    {
+      for (size_t j{}; j < range.count * shared_t::block_size && i < drawn.size();
+           ++j, ++i)
+      {
+        assert_are_equal(
+            drawn[i],
+            shared_t::engine_type::draw_at(
+                key, {}, range.first_block * shared_t::block_size + j));
+      }
+    }
+    assert_are_equal(i, drawn.size());
+  };
+  check(first, values);
+  check(second, generated);
+
+  // each consumer reserved alone, so its log is a single range.
+  assert_are_equal(first.reservations().size(), 1U);
+  assert_are_equal(second.reservations().size(), 1U);
+
+  auto unaudited = shared.make_consumer(2U);
+  unaudited.generate(generated);
+  assert_are_equal(unaudited.reservations().empty(), true);
+}
+
+// concurrent consumers receive disjoint ranges that together cover every
+// reserved block exactly once.
+void test_concurrent_reservations()
+{
+  using trait_t = threefry4x64_trait<20>;
+  using shared_t = shared_counter_engine<trait_t>;
+  static_assert(alignof(shared_t) == destructive_interference_size);
+  constexpr size_t threads = 8U;
+  constexpr size_t draws = 10000U;
+  shared_t shared{{1U, 2U, 3U, 4U}};
+
+  std::vector<std::vector<shared_t::block_range>> reservations(threads);
+  std::vector<std::thread> workers{};
+  for (size_t t{}; t < threads; ++t)
+  {
+    workers.emplace_back([&shared, &reservations, t] {
+      auto consumer = shared.make_consumer(4U, true);
+      for (size_t i{}; i < draws; ++i)
+      {
+        consumer();
+      }
+      reservations[t] = consumer.reservations();
+    });
+  }
+  for (auto& worker : workers)
+  {
+    worker.join();
+  }
+
+  std::vector<shared_t::block_range> ranges{};
+  for (const auto& log : reservations)
+  {
+    ranges.insert(ranges.end(), log.begin(), log.end());
+  }
+  std::sort(ranges.begin(), ranges.end(), [](const auto& l, const auto& r) {
+    return l.first_block < r.first_block;
+  });
+  uint64_t next{};
+  for (const auto& range : ranges)
+  {
+    assert_are_equal(range.first_block, next);
+    next += range.count;
+  }
+  assert_are_equal(next, shared.reserved());
+}
+
+// the block count is added to the full width counter, so a stream that
+// starts just below a word boundary carries into the higher words.
+void test_wide_counter()
+{
+  using trait_t = threefry4x64_trait<20>;
+  using counter_t = trait_t::counter_type;
+  const counter_t start{UINT64_MAX - 1U, UINT64_MAX, 7U, 0U};
+  test_blocks_match_engine<trait_t, uint64_t>(start);
+  shared_counter_engine<trait_t> shared{{}, start};
+  shared.reserve(2U);
+  assert_are_equal(shared.reserve(1U).first_counter,
+                   (counter_t{0U, 0U, 8U, 0U}));
+}
+
+int main()
+{
+  test_blocks_match_engine<philox4x32_trait<10>, uint32_t>({});
+  test_blocks_match_engine<philox2x64_trait<10>, uint64_t>({});
+  test_blocks_match_engine<threefry2x32_trait<20>, uint32_t>({UINT32_MAX, 0U});
+  test_blocks_match_engine<threefry4x64_trait<20>, uint32_t>({});
+  test_blocks_match_engine<threefry4x64_trait<20>, uint64_t>({});
+  test_consumer<philox4x64_trait<10>>();
+  test_consumer<threefry2x32_trait<20>>();
+  test_concurrent_reservations();
+  test_wide_counter();
+  std::cout << "success";
+}
@@ -0,0 +1,46 @@
+#include <cstdlib>
+#include <iostream>
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+using namespace qtfy::random::simd;
+
+void test_to_string()
+{
+  assert_are_equal(to_string(instruction_set::scalar), "scalar");
+  assert_are_equal(to_string(instruction_set::portable), "portable");
+  assert_are_equal(to_string(instruction_set::avx2), "avx2");
+  assert_are_equal(to_string(instruction_set::avx512), "avx512");
+}
+
+// the active instruction set is the one requested through QTFY_RANDOM_SIMD
+// when the cpu supports it and the detected one otherwise.
+void test_active_instruction_set()
+{
+  const auto detected = detected_instruction_set();
+  const auto active = active_instruction_set();
+  const char* requested = std::getenv("QTFY_RANDOM_SIMD");
+  auto expected = detected;
+  if (requested != nullptr)
+  {
+    for (auto isa : {instruction_set::scalar, instruction_set::portable,
+                     instruction_set::avx2, instruction_set::avx512})
+    {
+      if (to_string(isa) == requested && isa <= detected)
+      {
+        expected = isa;
+      }
+    }
+  }
+  assert_are_equal(active, expected);
+  assert_are_equal(active, active_instruction_set());
+}
+
+int main()
+{
+  test_to_string();
+  test_active_instruction_set();
+  std::cout << "active instruction set: "
+            << to_string(active_instruction_set());
+}
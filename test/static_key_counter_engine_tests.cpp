@@ -0,0 +1,100 @@
+#include <vector>
+
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+// the engine with a compile time key draws the values of the engine with the
+// same key at runtime, through every way of drawing them.
+template <class trait_t, typename trait_t::key_type key, class result_t,
+          size_t depth>
+void test_matches_runtime_key()
+{
+  using static_t = static_key_counter_engine<trait_t, key, result_t, depth>;
+  using runtime_t = counter_based_engine<trait_t, result_t, depth>;
+  const typename trait_t::counter_type start{3U, UINT32_MAX};
+
+  static_t fixed{{}, start};
+  runtime_t runtime{key, start};
+  for (size_t i{}; i < 50U; ++i)
+  {
+    assert_are_equal(fixed(), runtime());
+  }
+
+  std::vector<result_t> actual(333);
+  std::vector<result_t> expected(333);
+  fixed.generate(actual);
+  runtime.generate(expected);
+  assert_are_equal(actual, expected);
+
+  fixed.discard(1000U);
+  runtime.discard(1000U);
+  for (unsigned long long n : {0ULL, 1ULL, 17ULL, 1ULL << 33U})
+  {
+    assert_are_equal(fixed.at(n), runtime.at(n));
+  }
+  assert_are_equal(fixed.next_canonical(), runtime.next_canonical());
+  assert_are_equal(
+      (fixed.template next_canonical<float, 24, canonical_interval::open_open>()),
+      (runtime.template next_canonical<float, 24, canonical_interval::open_open>()));
+
+  std::vector<double> canonical_actual(101);
+  std::vector<double> canonical_expected(101);
+  fixed.fill_canonical(std::span<double>{canonical_actual});
+  runtime.fill_canonical(std::span<double>{canonical_expected});
+  assert_are_equal(canonical_actual, canonical_expected);
+
+  auto fixed_stream = fixed.template substream<16U>(5U);
+  auto runtime_stream = runtime.template substream<16U>(5U);
+  assert_are_equal(fixed_stream(), runtime_stream());
+  assert_are_equal(static_t::draw_at({}, start, 12345U),
+                   runtime_t::draw_at(key, start, 12345U));
+}
+
+template <class trait_t, typename trait_t::key_type key>
+void test_trait()
+{
+  using word_t = typename trait_t::word_type;
+  test_matches_runtime_key<trait_t, key, word_t, 1U>();
+  test_matches_runtime_key<trait_t, key, word_t, 16U>();
+  test_matches_runtime_key<trait_t, key, uint8_t, 1U>();
+  if constexpr (sizeof(word_t) == 8U)
+  {
+    test_matches_runtime_key<trait_t, key, uint32_t, 4U>();
+  }
+}
+
+void engine_is_constexpr()
+{
+  using trait_t = threefry4x64_trait<20>;
+  constexpr auto value = [] {
+    static_key_counter_engine<trait_t, trait_t::key_type{1U, 2U, 3U, 4U}>
+        engine{};
+    engine.discard(6U);
+    return engine();
+  }();
+  static_assert(value == threefry4x64<>::draw_at({1U, 2U, 3U, 4U}, {}, 6U));
+
+  // the key takes no space in the state.
+  static_assert(
+      sizeof(static_key_counter_engine<trait_t, trait_t::key_type{}>) +
+          sizeof(trait_t::internal_key_type) ==
+      sizeof(threefry4x64<>));
+}
+
+int main()
+{
+  test_trait<philox2x32_trait<10>, philox2x32_trait<10>::key_type{7U}>();
+  test_trait<philox4x32_trait<10>, philox4x32_trait<10>::key_type{7U, 8U}>();
+  test_trait<philox2x64_trait<10>, philox2x64_trait<10>::key_type{UINT64_MAX}>();
+  test_trait<philox4x64_trait<10>, philox4x64_trait<10>::key_type{1U, 2U}>();
+  test_trait<threefry2x32_trait<20>, threefry2x32_trait<20>::key_type{1U, 2U}>();
+  test_trait<threefry4x32_trait<20>,
+             threefry4x32_trait<20>::key_type{1U, 2U, 3U, 4U}>();
+  test_trait<threefry2x64_trait<20>, threefry2x64_trait<20>::key_type{5U, 6U}>();
+  test_trait<threefry4x64_trait<20>,
+             threefry4x64_trait<20>::key_type{UINT64_MAX, 0U, 1U, 2U}>();
+  engine_is_constexpr();
+  std::cout << "success";
+}
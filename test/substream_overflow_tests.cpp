@@ -0,0 +1,50 @@
+// the overflow check of substreams is only compiled into debug builds.
+#undef NDEBUG
+
+#include <csignal>
+#include <cstdlib>
+#include <string_view>
+
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+
+// set once every value inside the stream has been drawn, so that a check
+// that trips any earlier is reported as a failure of its own.
+volatile std::sig_atomic_t at_stream_end = 0;
+
+// runs past the end of a substream, which must trip the overflow check.
+// The test is registered to pass only if the process fails, and the failed
+// assertion is turned into a plain failing exit code for ctest, provided
+// that it tripped on the first value of the next stream. With the argument
+// "depth", an engine of depth four is moved to two blocks before the end of
+// its stream, so that the last blocks of its buffer belong to the next
+// stream, and the values of the first two must still be drawn.
+int main(int argc, char** argv)
+{
+  std::signal(SIGABRT, [](int) {
+    std::_Exit(at_stream_end != 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+  });
+  if (argc > 1 && std::string_view{argv[1]} == "depth")
+  {
+    using engine_t = philox2x32<uint32_t, 10, 4U>;
+    using counter_t = engine_t::counter_type;
+    auto runaway = engine_t{}.substream<20U>(7U);
+    runaway.discard((counter_t{1U} << 44U) - 2U, 0U);
+    for (int i{}; i < 4; ++i)
+    {
+      std::cout << runaway() << '\n';
+    }
+    at_stream_end = 1;
+    std::cout << runaway();
+    return 0;
+  }
+  using engine_t = philox2x32<>;
+  using counter_t = engine_t::counter_type;
+  const auto stream = engine_t{}.substream<20U>(7U);
+  auto runaway = stream;
+  runaway.discard(counter_t{1U} << 44U, 0U);
+  at_stream_end = 1;
+  std::cout << runaway();
+}
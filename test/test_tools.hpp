@@ -1,9 +1,11 @@
 #ifndef QUANTIFEYE_TEST_TOOLS_HPP
 #define QUANTIFEYE_TEST_TOOLS_HPP
 
+#include <algorithm>
 #include <iostream>
 #include <random>
 #include <stdexcept>
+#include <vector>
 #include "qtfy/coro/generator.hpp"
 #include "qtfy/random.hpp"
 
@@ -35,5 +37,147 @@ generator<counter<word_t, words>> counters(size_t amount)
   }
 }
 
+template <class trait_t>
+std::vector<typename trait_t::counter_type> expected_bijections(
+    const std::vector<typename trait_t::counter_type>& input,
+    typename trait_t::internal_key_type key)
+{
+  std::vector<typename trait_t::counter_type> expected{};
+  for (auto ctr : input)
+  {
+    expected.push_back(trait_t::bijection(ctr, key));
+  }
+  return expected;
+}
+
+// checks that bijection_n of trait_t gives the scalar bijection for every
+// group of n consecutive counters of input.
+template <class trait_t, size_t n>
+void assert_interleaved_matches_bijection(
+    const std::vector<typename trait_t::counter_type>& input,
+    const std::vector<typename trait_t::counter_type>& expected,
+    typename trait_t::internal_key_type key)
+{
+  for (size_t i{}; i + n <= input.size(); i += n)
+  {
+    std::array<typename trait_t::counter_type, n> group{};
+    std::copy_n(input.begin() + static_cast<std::ptrdiff_t>(i), n,
+                group.begin());
+    group = trait_t::bijection_n(group, key);
+    for (size_t j{}; j < n; ++j)
+    {
+      assert_are_equal(group[j], expected[i + j]);
+    }
+  }
+}
+
+// checks the batch bijection of trait_t, bijection_n and each simd kernel
+// that the cpu supports against the scalar bijection.
+template <class trait_t, class kernel_t>
+void assert_batch_matches_bijection(
+    const std::vector<typename trait_t::counter_type>& input,
+    typename trait_t::internal_key_type key)
+{
+  using counter_t = typename trait_t::counter_type;
+  const auto expected = expected_bijections<trait_t>(input, key);
+
+  std::vector<counter_t> actual(input.size());
+  trait_t::bijection_batch(input, actual, key);
+  assert_are_equal(expected, actual);
+
+  assert_interleaved_matches_bijection<trait_t, 1U>(input, expected, key);
+  assert_interleaved_matches_bijection<trait_t, 3U>(input, expected, key);
+  assert_interleaved_matches_bijection<trait_t, 8U>(input, expected, key);
+
+  // width is the size of the registers of kernel in bytes. Every full group
+  // of lanes has to be processed, so a kernel that does nothing fails.
+  [[maybe_unused]] auto check_kernel = [&](auto kernel, size_t width) {
+    const size_t lanes = width / sizeof(typename trait_t::word_type);
+    std::vector<counter_t> results(input.size());
+    size_t done{};
+    // the threefry kernels also take the tweak, which a function pointer
+    // cannot default.
+    if constexpr (requires { trait_t::default_tweak; })
+    {
+      done = kernel(input.data(), results.data(), input.size(), key,
+                    trait_t::default_tweak);
+    }
+    else
+    {
+      done = kernel(input.data(), results.data(), input.size(), key);
+    }
+    assert_are_equal(done, input.size() - input.size() % lanes);
+    for (size_t i{}; i < done; ++i)
+    {
+      assert_are_equal(results[i], expected[i]);
+    }
+  };
+
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+  // the portable kernel at the width of sse / neon, avx2 and avx512.
+  check_kernel(kernel_t::template portable<16U>, 16U);
+  check_kernel(kernel_t::template portable<32U>, 32U);
+  check_kernel(kernel_t::template portable<64U>, 64U);
+#endif
+
+#if QTFY_RANDOM_X86_SIMD
+  if (__builtin_cpu_supports("avx2"))
+  {
+    check_kernel(kernel_t::avx2, 32U);
+  }
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    check_kernel(kernel_t::avx512, 64U);
+  }
+#endif
+}
+
+// checks bijection_keys of trait_t and each keys kernel that the cpu
+// supports against the scalar bijection of every key.
+template <class trait_t, class kernel_t>
+void assert_keys_match_bijection(
+    typename trait_t::counter_type ctr,
+    const std::vector<typename trait_t::key_type>& keys)
+{
+  using counter_t = typename trait_t::counter_type;
+  std::vector<counter_t> expected{};
+  for (auto key : keys)
+  {
+    expected.push_back(trait_t::bijection(ctr, trait_t::set_key(key)));
+  }
+
+  std::vector<counter_t> actual(keys.size());
+  trait_t::bijection_keys(ctr, keys, actual);
+  assert_are_equal(expected, actual);
+
+  [[maybe_unused]] auto check_kernel = [&](auto kernel, size_t width) {
+    const size_t lanes = width / sizeof(typename trait_t::word_type);
+    std::vector<counter_t> results(keys.size());
+    const size_t done = kernel(ctr, keys.data(), results.data(), keys.size());
+    assert_are_equal(done, keys.size() - keys.size() % lanes);
+    for (size_t i{}; i < done; ++i)
+    {
+      assert_are_equal(results[i], expected[i]);
+    }
+  };
+
+#if QTFY_RANDOM_VECTOR_EXTENSIONS
+  check_kernel(kernel_t::template portable_keys<16U>, 16U);
+  check_kernel(kernel_t::template portable_keys<32U>, 32U);
+  check_kernel(kernel_t::template portable_keys<64U>, 64U);
+#endif
+
+#if QTFY_RANDOM_X86_SIMD
+  if (__builtin_cpu_supports("avx2"))
+  {
+    check_kernel(kernel_t::avx2_keys, 32U);
+  }
+  if (__builtin_cpu_supports("avx512f"))
+  {
+    check_kernel(kernel_t::avx512_keys, 64U);
+  }
+#endif
+}
+
 }  // namespace qtft::random
 #endif  // QUANTIFEYE_TEST_TOOLS_HPP
@@ -14,10 +14,25 @@ struct test_case
   counter<word_t, words> expected;
 };
 
+template <class word_t, size_t words, unsigned rounds, word_t t0 = 0U,
+          word_t t1 = 0U>
+using trait_for = std::conditional_t<
+    words == 2U,
+    std::conditional_t<std::is_same_v<word_t, uint32_t>,
+                       threefry2x32_trait<rounds, static_cast<uint32_t>(t0),
+                                          static_cast<uint32_t>(t1)>,
+                       threefry2x64_trait<rounds, t0, t1>>,
+    std::conditional_t<std::is_same_v<word_t, uint32_t>,
+                       threefry4x32_trait<rounds, static_cast<uint32_t>(t0),
+                                          static_cast<uint32_t>(t1)>,
+                       threefry4x64_trait<rounds, t0, t1>>>;
+
 template <class word_t, size_t words, unsigned rounds, word_t t0 = 0U,
           word_t t1 = 0U>
 void test(std::vector<test_case<word_t, words>> cases)
 {
+  using trait_t = trait_for<word_t, words, rounds, t0, t1>;
+  using kernel_t = simd::threefry_kernel<trait_t>;
   for (auto x : cases)
   {
     auto bijection = threefry_factory<word_t, words, rounds, t0, t1>(x.key);
@@ -26,6 +41,18 @@ void test(std::vector<test_case<word_t, words>> cases)
     {
       throw std::exception{};
     }
+
+    // enough copies to fill every lane of the widest kernel twice, plus a
+    // remainder for the scalar tail.
+    const std::vector<counter<word_t, words>> input(37, x.ctr);
+    std::vector<counter<word_t, words>> results(input.size());
+    trait_t::bijection_batch(input, results, trait_t::set_key(x.key));
+    for (auto result : results)
+    {
+      assert_are_equal(result, x.expected);
+    }
+    assert_batch_matches_bijection<trait_t, kernel_t>(input,
+                                                      trait_t::set_key(x.key));
   }
 }
 
@@ -196,17 +223,152 @@ void compare_runtime_and_compile_time_key()
   test<uint32_t, 2, 20, 7, 8, {2, 3}>();
 }
 
+template <class trait_t>
+void test_batch(typename trait_t::key_type key)
+{
+  using kernel_t = simd::threefry_kernel<trait_t>;
+  using counter_t = typename trait_t::counter_type;
+  for (size_t size : {0U, 1U, 7U, 8U, 16U, 33U, 100U})
+  {
+    std::vector<counter_t> input{};
+    for (auto ctr : counters<typename trait_t::word_type, counter_t{}.size()>(size))
+    {
+      input.push_back(ctr);
+    }
+    assert_batch_matches_bijection<trait_t, kernel_t>(input,
+                                                      trait_t::set_key(key));
+  }
+}
+
+template <class trait_t>
+void test_keys(typename trait_t::counter_type ctr)
+{
+  using kernel_t = simd::threefry_kernel<trait_t>;
+  using key_type = typename trait_t::key_type;
+  for (size_t size : {0U, 1U, 7U, 8U, 16U, 33U, 100U})
+  {
+    std::vector<key_type> keys{};
+    for (auto key : counters<typename trait_t::word_type, key_type{}.size()>(size))
+    {
+      keys.push_back(key);
+    }
+    assert_keys_match_bijection<trait_t, kernel_t>(ctr, keys);
+  }
+}
+
+void test_keys_random_keys()
+{
+  test_keys<threefry4x64_trait<20>>({1, 2, 3, 4});
+  test_keys<threefry2x64_trait<20>>({5, 6});
+  test_keys<threefry4x32_trait<20>>({7, 8, 9, 10});
+  test_keys<threefry2x32_trait<20>>({11, 12});
+  test_keys<threefry4x64_trait<13, 3, 4>>({UINT64_MAX, 0, 1, 2});
+  test_keys<threefry4x32_trait<72, 8, 9>>({UINT32_MAX, 0, 1, 2});
+}
+
+void test_batch_random_counters()
+{
+  test_batch<threefry4x64_trait<20>>({1, 2, 3, 4});
+  test_batch<threefry2x64_trait<20>>({5, 6});
+  test_batch<threefry4x32_trait<20>>({7, 8, 9, 10});
+  test_batch<threefry2x32_trait<20>>({11, 12});
+  test_batch<threefry4x64_trait<13, 3, 4>>({UINT64_MAX, 0, 1, 2});
+  test_batch<threefry2x64_trait<72, 5, 6>>({UINT64_MAX, 7});
+  test_batch<threefry4x32_trait<72, 8, 9>>({UINT32_MAX, 0, 1, 2});
+  test_batch<threefry2x32_trait<32, 10, 11>>({UINT32_MAX, 3});
+  test_batch<threefry4x64_trait<1>>({1, 2, 3, 4});
+}
+
+// the runtime tweak trait over base_t with tweak must reproduce tweaked_t,
+// the same threefry with that tweak as template parameter.
+template <class base_t, class tweaked_t>
+void test_tweak(typename base_t::key_type key,
+                typename base_t::tweak_type tweak)
+{
+  using runtime_t = threefry_runtime_tweak_trait<base_t>;
+  using counter_t = typename base_t::counter_type;
+  using word_t = typename base_t::word_type;
+  const auto runtime_key = runtime_t::set_key(key, tweak);
+  const auto tweaked_key = tweaked_t::set_key(key);
+
+  std::vector<counter_t> input{};
+  for (auto ctr : counters<word_t, counter_t{}.size()>(100))
+  {
+    input.push_back(ctr);
+  }
+  const auto expected = expected_bijections<tweaked_t>(input, tweaked_key);
+  for (size_t i{}; i < input.size(); ++i)
+  {
+    assert_are_equal(runtime_t::bijection(input[i], runtime_key), expected[i]);
+  }
+  std::vector<counter_t> actual(input.size());
+  runtime_t::bijection_batch(input, actual, runtime_key);
+  assert_are_equal(expected, actual);
+
+  // the default tweak is the one of base_t.
+  assert_are_equal(runtime_t::bijection(input[1], runtime_t::set_key(key)),
+                   base_t::bijection(input[1], base_t::set_key(key)));
+
+  counter_based_engine<tweaked_t> tweaked{key};
+  const auto engine =
+      counter_based_engine<runtime_t>{key}.with_tweak(tweak);
+  auto sequential = engine;
+  std::vector<word_t> generated(1000);
+  auto batched = engine;
+  batched.generate(generated.begin(), generated.end());
+  for (size_t i{}; i < generated.size(); ++i)
+  {
+    const auto value = tweaked();
+    assert_are_equal(sequential(), value);
+    assert_are_equal(generated[i], value);
+  }
+}
+
+void compare_runtime_and_compile_time_tweak()
+{
+  test_tweak<threefry4x64_trait<20>, threefry4x64_trait<20, 1, 2>>(
+      {1, 2, 3, 4}, {1, 2});
+  test_tweak<threefry4x64_trait<13, 3, 4>, threefry4x64_trait<13, 5, 6>>(
+      {UINT64_MAX, 0, 1, 2}, {5, 6});
+  test_tweak<threefry4x64_trait<72>,
+             threefry4x64_trait<72, UINT64_MAX, 0x0123456789abcdef>>(
+      {}, {UINT64_MAX, 0x0123456789abcdef});
+  test_tweak<threefry4x32_trait<20>, threefry4x32_trait<20, 7, 8>>(
+      {7, 8, 9, 10}, {7, 8});
+  test_tweak<threefry4x32_trait<72, 1, 1>, threefry4x32_trait<72, 0, 9>>(
+      {UINT32_MAX, 0, 1, 2}, {0, 9});
+
+  // different tweaks give different streams.
+  threefry4x64_runtime_tweak<> engine{{1, 2, 3, 4}};
+  auto first = engine.with_tweak({0, 1});
+  auto second = engine.with_tweak({1, 0});
+  if (first() == second())
+  {
+    throw std::exception{};
+  }
+}
+
 void bijection_is_constexpr()
 {
   constexpr auto bij = threefry_factory<uint64_t, 4, 72, 0, 0>({});
   constexpr auto x = bij({});
   using t = std::array<int, x[0]>;
+  using trait_t = threefry4x64_trait<72>;
+  constexpr auto y = trait_t::bijection_n<2U>({}, trait_t::set_key({}));
+  static_assert(y[0] == trait_t::bijection({}, trait_t::set_key({})));
+  using runtime_t = threefry4x64_runtime_tweak_trait<72>;
+  static_assert(runtime_t::bijection({}, runtime_t::set_key({}, {3, 4})) ==
+                threefry4x64_trait<72, 3, 4>::bijection(
+                    {}, threefry4x64_trait<72, 3, 4>::set_key({})));
 }
 
 int main()
 {
   test_run_time_key();
   compare_runtime_and_compile_time_key();
+  test_batch_random_counters();
+  compare_runtime_and_compile_time_tweak();
+  test_keys_random_keys();
   bijection_is_constexpr();
   std::cout << "success" << '\n';
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#include <iostream>
+#include <random>
+#include "qtfy/random.hpp"
+#include "test_tools.hpp"
+
+using namespace qtfy::random;
+using namespace qtfy::random::utilities;
+
+// the product as computed by the portable implementation, which is what
+// big_mul uses during constant evaluation.
+template <uint64_t left, std::unsigned_integral right_t, std::endian endian>
+consteval auto constant_big_mul(right_t right) noexcept
+{
+  return big_mul<left, right_t, endian>(right);
+}
+
+template <uint64_t left, std::unsigned_integral right_t, std::endian endian>
+void test_big_mul(right_t right, right_t expected_hi, right_t expected_lo)
+{
+  const auto actual = big_mul<left, right_t, endian>(right);
+  assert_are_equal(actual.hi, expected_hi);
+  assert_are_equal(actual.lo, expected_lo);
+}
+
+template <uint64_t left, std::unsigned_integral right_t>
+void test_big_mul(right_t right, right_t expected_hi, right_t expected_lo)
+{
+  test_big_mul<left, right_t, std::endian::little>(right, expected_hi,
+                                                   expected_lo);
+  test_big_mul<left, right_t, std::endian::big>(right, expected_hi,
+                                                expected_lo);
+}
+
+void test_big_mul_known_values()
+{
+  test_big_mul<0xD2B74407B1CE6E93, uint64_t>(0U, 0U, 0U);
+  test_big_mul<0xD2B74407B1CE6E93, uint64_t>(1U, 0U, 0xD2B74407B1CE6E93);
+  test_big_mul<0xD2B74407B1CE6E93, uint64_t>(
+      UINT64_MAX, 0xD2B74407B1CE6E92, 0x2D48BBF84E31916D);
+  test_big_mul<UINT64_MAX, uint64_t>(UINT64_MAX, 0xFFFFFFFFFFFFFFFE, 1U);
+  test_big_mul<0xD256D193, uint32_t>(UINT32_MAX, 0xD256D192, 0x2DA92E6D);
+  test_big_mul<0xD256D193, uint32_t>(2U, 1U, 0xA4ADA326);
+}
+
+// the runtime and constant evaluation paths must agree for both layouts.
+template <uint64_t left, std::endian endian>
+void test_big_mul_matches_constant_evaluation()
+{
+  constexpr uint64_t value = 0x0123456789ABCDEF;
+  constexpr auto constant = constant_big_mul<left, uint64_t, endian>(value);
+  const volatile uint64_t runtime_value = value;
+  const auto runtime = big_mul<left, uint64_t, endian>(runtime_value);
+  assert_are_equal(constant.hi, runtime.hi);
+  assert_are_equal(constant.lo, runtime.lo);
+
+  std::mt19937_64 engine{};
+  for (int i{}; i < 1000; ++i)
+  {
+    const uint64_t right = engine();
+    const auto actual = big_mul<left, uint64_t, endian>(right);
+    const uint64_t low = left * right;
+    assert_are_equal(actual.lo, low);
+#if defined(__SIZEOF_INT128__)
+    const auto expected = uint128_t{left} * right;
+    assert_are_equal(actual.hi, static_cast<uint64_t>(expected >> 64U));
+#endif
+  }
+}
+
+void test_rotate_left()
+{
+  static_assert(rotate_left<1U>(uint32_t{0x80000001}) == 3U);
+  static_assert(rotate_left<32U>(uint32_t{5U}) == 5U);
+  static_assert(rotate_left<0U>(uint64_t{5U}) == 5U);
+  static_assert(rotate_left<63U>(uint64_t{1U}) == uint64_t{1U} << 63U);
+  assert_are_equal(rotate_left<8U>(uint64_t{0xFF00000000000000}),
+                   uint64_t{0xFF});
+}
+
+void test_add_with_carry()
+{
+  constexpr uint32_t max32 = std::numeric_limits<uint32_t>::max();
+  auto test = [](uint32_t left, uint32_t right, bool carry_in,
+                 uint32_t expected, bool expected_carry) {
+    bool carry = carry_in;
+    assert_are_equal(add_with_carry(left, right, carry), expected);
+    assert_are_equal(carry, expected_carry);
+
+    bool borrow = carry_in;
+    assert_are_equal(subtract_with_borrow(expected, right, borrow), left);
+    assert_are_equal(borrow, expected_carry);
+  };
+
+  test(1U, 2U, false, 3U, false);
+  test(1U, 2U, true, 4U, false);
+  test(max32, 1U, false, 0U, true);
+  test(max32, 0U, true, 0U, true);
+  test(max32, max32, true, max32, true);
+  test(0U, max32, true, 0U, true);
+}
+
+int main()
+{
+  test_big_mul_known_values();
+  test_big_mul_matches_constant_evaluation<0xD2B74407B1CE6E93,
+                                           std::endian::little>();
+  test_big_mul_matches_constant_evaluation<0xCA5A826395121157,
+                                           std::endian::big>();
+  test_rotate_left();
+  test_add_with_carry();
+  std::cout << "success";
+}